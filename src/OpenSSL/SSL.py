@@ -1,6 +1,8 @@
+import io
 import os
 import socket
 import typing
+from collections import deque
 from errno import errorcode
 from functools import partial, wraps
 from itertools import chain, count
@@ -10,6 +12,9 @@ from weakref import WeakValueDictionary
 from OpenSSL._util import (
     UNSPECIFIED as _UNSPECIFIED,
 )
+from OpenSSL._util import (
+    byte_string as _byte_string,
+)
 from OpenSSL._util import (
     exception_from_error_queue as _exception_from_error_queue,
 )
@@ -32,12 +37,15 @@ from OpenSSL._util import (
     text_to_bytes_and_warn as _text_to_bytes_and_warn,
 )
 from OpenSSL.crypto import (
+    FILETYPE_ASN1,
     FILETYPE_PEM,
     X509,
     PKey,
     X509Name,
     X509Store,
+    _new_mem_buf,
     _PassphraseHelper,
+    _read_pem_objects,
 )
 
 __all__ = [
@@ -136,8 +144,12 @@ __all__ = [
     "NO_OVERLAPPING_PROTOCOLS",
     "SSLeay_version",
     "Session",
+    "Provider",
+    "load_provider",
     "Context",
     "Connection",
+    "ConnectionInfo",
+    "RecordedMessage",
     "X509VerificationCodes",
 ]
 
@@ -719,6 +731,225 @@ class _CookieVerifyCallbackHelper(_CallbackExceptionHelper):
         )
 
 
+# The TLS 1.3 cipher suites by name, with their code and whether their
+# handshake hash is SHA-384 rather than SHA-256.  An external PSK can only be
+# used with cipher suites of the hash its session was created with.
+_TLS13_CIPHER_SUITES = {
+    "TLS_AES_128_GCM_SHA256": (b"\x13\x01", False),
+    "TLS_AES_256_GCM_SHA384": (b"\x13\x02", True),
+    "TLS_CHACHA20_POLY1305_SHA256": (b"\x13\x03", False),
+    "TLS_AES_128_CCM_SHA256": (b"\x13\x04", False),
+    "TLS_AES_128_CCM_8_SHA256": (b"\x13\x05", False),
+}
+
+# TLS_AES_128_GCM_SHA256, which every TLS 1.3 implementation must support.
+_PSK_TLS13_CIPHER = b"\x13\x01"
+
+
+def _psk_cipher(ssl):
+    """
+    Return the code of the TLS 1.3 cipher suite to associate an external PSK
+    with, given the cipher suites enabled on *ssl*.
+
+    SHA-256 is the default hash of external PSKs (RFC 8446, section 4.2.11)
+    and the one an OpenSSL server without a certificate prefers, so SHA-384
+    is only used if no cipher suite based on SHA-256 is enabled.
+    """
+    sha384 = None
+    i = 0
+    while True:
+        name = _lib.SSL_get_cipher_list(ssl, i)
+        if name == _ffi.NULL:
+            break
+        i += 1
+        code, is_sha384 = _TLS13_CIPHER_SUITES.get(
+            _ffi.string(name).decode("ascii"), (None, None)
+        )
+        if code is None:
+            continue
+        if not is_sha384:
+            return code
+        if sha384 is None:
+            sha384 = code
+    return _PSK_TLS13_CIPHER if sha384 is None else sha384
+
+
+def _new_psk_session(ssl, key, cipher_code=None):
+    """
+    Return a new ``SSL_SESSION`` that uses *key* as a TLS 1.3 external PSK
+    with the cipher suite *cipher_code*, or one chosen by :func:`_psk_cipher`.
+    The caller owns the session.
+    """
+    if not isinstance(key, bytes):
+        raise TypeError("PSK must be a byte string.")
+    if cipher_code is None:
+        cipher_code = _psk_cipher(ssl)
+    cipher = _lib.SSL_CIPHER_find(ssl, cipher_code)
+    _openssl_assert(cipher != _ffi.NULL)
+    session = _lib.Cryptography_SSL_SESSION_new()
+    _openssl_assert(session != _ffi.NULL)
+    if not _lib.SSL_SESSION_set1_master_key(session, key, len(key)):
+        _lib.SSL_SESSION_free(session)
+        raise ValueError("PSK is too long.")
+    _openssl_assert(_lib.SSL_SESSION_set_cipher(session, cipher) == 1)
+    _openssl_assert(
+        _lib.SSL_SESSION_set_protocol_version(session, TLS1_3_VERSION) == 1
+    )
+    return session
+
+
+class _PSKServerCallbackHelper(_CallbackExceptionHelper):
+    """
+    Wrap a callback such that it can be used to find the PSK for the
+    identity offered by a client, for TLS 1.3 and for earlier versions.
+    """
+
+    def __init__(self, callback):
+        _CallbackExceptionHelper.__init__(self)
+
+        @wraps(callback)
+        def wrapper(ssl, identity, identity_len, sessionp):
+            try:
+                conn = Connection._reverse_mapping[ssl]
+                key = callback(conn, _ffi.buffer(identity, identity_len)[:])
+                if key is None:
+                    sessionp[0] = _ffi.NULL
+                else:
+                    sessionp[0] = _new_psk_session(ssl, key)
+                return 1
+            except Exception as e:
+                self._problems.append(e)
+                return 0
+
+        @wraps(callback)
+        def legacy_wrapper(ssl, identity, psk, max_psk_len):
+            try:
+                # OpenSSL falls back to this callback for TLS 1.3 when the
+                # one above does not find a PSK; do not look twice.
+                if self.callback is not None and (
+                    _lib.SSL_version(ssl) == TLS1_3_VERSION
+                ):
+                    return 0
+                conn = Connection._reverse_mapping[ssl]
+                if identity == _ffi.NULL:
+                    identity = b""
+                else:
+                    identity = _ffi.string(identity)
+                key = callback(conn, identity)
+                if key is None:
+                    return 0
+                if not isinstance(key, bytes):
+                    raise TypeError("PSK must be a byte string.")
+                if len(key) > max_psk_len:
+                    raise ValueError("PSK is too long.")
+                psk[0 : len(key)] = key
+                return len(key)
+            except Exception as e:
+                self._problems.append(e)
+                return 0
+
+        if _lib.Cryptography_HAS_PSK_TLSv1_3:
+            self.callback = _ffi.callback(
+                "int (*)(SSL *, const unsigned char *, size_t, "
+                "SSL_SESSION **)",
+                wrapper,
+            )
+        else:
+            self.callback = None
+        self.legacy_callback = _ffi.callback(
+            "unsigned int (*)(SSL *, const char *, unsigned char *, "
+            "unsigned int)",
+            legacy_wrapper,
+        )
+
+
+class _PSKClientCallbackHelper(_CallbackExceptionHelper):
+    """
+    Wrap a callback such that it can be used to choose the PSK identity and
+    key a client offers, for TLS 1.3 and for earlier versions.
+    """
+
+    def __init__(self, callback):
+        _CallbackExceptionHelper.__init__(self)
+
+        def call(conn, hint):
+            result = callback(conn, hint)
+            if result is None:
+                return None
+            identity, key = result
+            if not isinstance(identity, bytes):
+                raise TypeError("PSK identity must be a byte string.")
+            return identity, key
+
+        @wraps(callback)
+        def wrapper(ssl, md, identityp, identity_len, sessionp):
+            try:
+                conn = Connection._reverse_mapping[ssl]
+                result = call(conn, None)
+                if result is None:
+                    sessionp[0] = _ffi.NULL
+                    return 1
+                identity, key = result
+                # Keep the identity alive until OpenSSL has copied it into
+                # the ClientHello.
+                conn._psk_identity = _ffi.new("unsigned char[]", identity)
+                # After a HelloRetryRequest OpenSSL passes the handshake hash
+                # of the cipher suite the server chose, and the PSK must use
+                # the same hash: use that cipher suite.
+                cipher_code = None
+                if md != _ffi.NULL:
+                    cipher_code = conn._psk_hello_retry_cipher
+                sessionp[0] = _new_psk_session(ssl, key, cipher_code)
+                identityp[0] = conn._psk_identity
+                identity_len[0] = len(identity)
+                return 1
+            except Exception as e:
+                self._problems.append(e)
+                return 0
+
+        @wraps(callback)
+        def legacy_wrapper(
+            ssl, hint, identity, max_identity_len, psk, max_psk_len
+        ):
+            try:
+                conn = Connection._reverse_mapping[ssl]
+                if hint != _ffi.NULL:
+                    hint = _ffi.string(hint)
+                else:
+                    hint = None
+                result = call(conn, hint)
+                if result is None:
+                    return 0
+                client_identity, key = result
+                if not isinstance(key, bytes):
+                    raise TypeError("PSK must be a byte string.")
+                if len(client_identity) > max_identity_len:
+                    raise ValueError("PSK identity is too long.")
+                if len(key) > max_psk_len:
+                    raise ValueError("PSK is too long.")
+                client_identity += b"\0"
+                identity[0 : len(client_identity)] = client_identity
+                psk[0 : len(key)] = key
+                return len(key)
+            except Exception as e:
+                self._problems.append(e)
+                return 0
+
+        if _lib.Cryptography_HAS_PSK_TLSv1_3:
+            self.callback = _ffi.callback(
+                "int (*)(SSL *, const EVP_MD *, const unsigned char **, "
+                "size_t *, SSL_SESSION **)",
+                wrapper,
+            )
+        else:
+            self.callback = None
+        self.legacy_callback = _ffi.callback(
+            "unsigned int (*)(SSL *, const char *, char *, unsigned int, "
+            "unsigned char *, unsigned int)",
+            legacy_wrapper,
+        )
+
+
 def _asFileDescriptor(obj):
     fd = None
     if not isinstance(obj, int):
@@ -781,11 +1012,148 @@ _requires_alpn = _make_requires(
 )
 
 
+_requires_psk = _make_requires(
+    getattr(_lib, "Cryptography_HAS_PSK", None), "PSK not available"
+)
+
+
 _requires_keylog = _make_requires(
     getattr(_lib, "Cryptography_HAS_KEYLOG", None), "Key logging not available"
 )
 
 
+_requires_sigalgs = _make_requires(
+    getattr(_lib, "Cryptography_HAS_SIGALGS", None),
+    "Signature algorithm lists not available",
+)
+
+
+_requires_key_update = _make_requires(
+    hasattr(_lib, "SSL_key_update"), "Key updates not available"
+)
+
+
+_requires_providers = _make_requires(
+    getattr(_lib, "Cryptography_HAS_PROVIDERS", None),
+    "Providers not available",
+)
+
+
+# The record content types of alerts and handshake messages.
+_SSL3_RT_ALERT = 21
+_SSL3_RT_HANDSHAKE = 22
+
+# The ServerHello.random value which marks a HelloRetryRequest, RFC 8446
+# section 4.1.3.
+_HELLO_RETRY_REQUEST_RANDOM = bytes.fromhex(
+    "cf21ad74e59a6111be1d8c021e65b891c2a211167abb8c5e079e09e2c8a8339c"
+)
+
+
+# Names of the TLS SignatureScheme code points, RFC 8446 section 4.2.3.  TLS
+# 1.2 SignatureAndHashAlgorithm pairs share the same encoding.
+_SIGNATURE_SCHEMES = {
+    0x0201: "rsa_pkcs1_sha1",
+    0x0203: "ecdsa_sha1",
+    0x0401: "rsa_pkcs1_sha256",
+    0x0403: "ecdsa_secp256r1_sha256",
+    0x0501: "rsa_pkcs1_sha384",
+    0x0503: "ecdsa_secp384r1_sha384",
+    0x0601: "rsa_pkcs1_sha512",
+    0x0603: "ecdsa_secp521r1_sha512",
+    0x0804: "rsa_pss_rsae_sha256",
+    0x0805: "rsa_pss_rsae_sha384",
+    0x0806: "rsa_pss_rsae_sha512",
+    0x0807: "ed25519",
+    0x0808: "ed448",
+    0x0809: "rsa_pss_pss_sha256",
+    0x080A: "rsa_pss_pss_sha384",
+    0x080B: "rsa_pss_pss_sha512",
+    0x081A: "ecdsa_brainpoolP256r1tls13_sha256",
+    0x081B: "ecdsa_brainpoolP384r1tls13_sha384",
+    0x081C: "ecdsa_brainpoolP512r1tls13_sha512",
+}
+
+
+def _server_key_exchange_params_length(body):
+    """
+    Return the length of the (EC)DH parameters at the start of a TLS 1.2
+    ServerKeyExchange *body*, or :obj:`None` if they cannot be parsed.
+    """
+
+    def signature_follows(end):
+        # The parameters are followed by the signature algorithm and a
+        # length-prefixed signature which ends the message.
+        if len(body) < end + 4:
+            return False
+        return end + 4 + int.from_bytes(body[end + 2 : end + 4], "big") == (
+            len(body)
+        )
+
+    # ECDHE: named_curve (3), the curve and a length-prefixed point.
+    if len(body) >= 4 and body[0] == 3:
+        end = 4 + body[3]
+        if signature_follows(end):
+            return end
+
+    # DHE: the length-prefixed p, g and Ys.
+    end = 0
+    for _ in range(3):
+        if len(body) < end + 2:
+            return None
+        end += 2 + int.from_bytes(body[end : end + 2], "big")
+    if signature_follows(end):
+        return end
+    return None
+
+
+def _signature_scheme(version, data):
+    """
+    Return the name of the signature algorithm used in the handshake message
+    *data* if it is a CertificateVerify or ServerKeyExchange message, or
+    :obj:`None`.
+    """
+    if version >> 8 == 0xFE:
+        # DTLS has a longer handshake header; only DTLS 1.2 has sigalgs.
+        if version != 0xFEFD:
+            return None
+        body = data[12:]
+    else:
+        if version < TLS1_2_VERSION:
+            return None
+        body = data[4:]
+
+    if not data or data[0] not in (12, 15):
+        return None
+    offset = 0
+    if data[0] == 12:
+        offset = _server_key_exchange_params_length(body)
+        if offset is None:
+            return None
+    if len(body) < offset + 2:
+        return None
+
+    scheme = int.from_bytes(body[offset : offset + 2], "big")
+    return _SIGNATURE_SCHEMES.get(scheme, f"0x{scheme:04x}")
+
+
+def _gc_x509(x509):
+    return _ffi.gc(x509, _lib.X509_free)
+
+
+def _gc_x509_crl(crl):
+    return _ffi.gc(crl, _lib.X509_CRL_free)
+
+
+def _read_pem_certificates(buffer):
+    certificates = _read_pem_objects(
+        buffer, _lib.PEM_read_bio_X509, _gc_x509, Error
+    )
+    if not certificates:
+        raise Error([("PEM routines", "", "no certificates found")])
+    return certificates
+
+
 class Session:
     """
     A class representing an SSL session.  A session defines certain connection
@@ -798,6 +1166,125 @@ class Session:
     pass
 
 
+class Provider:
+    """
+    An OpenSSL 3 provider, a module that supplies implementations of
+    cryptographic algorithms, as returned by :func:`load_provider`.
+
+    .. versionadded:: 24.2.0
+    """
+
+    def __init__(self):
+        raise TypeError("Use load_provider to load a provider.")
+
+    @property
+    def name(self):
+        """
+        The name the provider was loaded with, as :class:`bytes`.
+        """
+        return self._name
+
+    def unload(self):
+        """
+        Unload the provider.  Once every :func:`load_provider` call for it
+        has been matched by an unload, its algorithms are no longer
+        available.  Unloading it again does nothing.
+
+        :return: None
+        """
+        if self._provider is None:
+            return
+        _openssl_assert(_lib.OSSL_PROVIDER_unload(self._provider) == 1)
+        self._provider = None
+
+
+@_requires_providers
+def load_provider(name):
+    """
+    Load an OpenSSL 3 provider into the default library context, making its
+    algorithms available to every :class:`Context` and to
+    :mod:`OpenSSL.crypto`.
+
+    Loading a provider other than ``b"default"`` stops the default provider
+    from being loaded automatically, so load it explicitly as well if it is
+    still wanted.
+
+    :param name: The provider name, such as ``b"default"``, ``b"legacy"``,
+        ``b"fips"`` or the name of a third-party provider module.
+    :type name: :class:`bytes`
+    :return: The loaded provider.
+    :rtype: :class:`Provider`
+
+    .. versionadded:: 24.2.0
+    """
+    if not isinstance(name, bytes):
+        raise TypeError("name must be a byte string.")
+
+    provider = _lib.OSSL_PROVIDER_load(_ffi.NULL, name)
+    if provider == _ffi.NULL:
+        _raise_current_error()
+
+    result = Provider.__new__(Provider)
+    result._name = name
+    result._provider = provider
+    return result
+
+
+class RecordedMessage(typing.NamedTuple):
+    """
+    A protocol message sent or received by a connection, as returned by
+    :meth:`Connection.get_recorded_messages`.
+
+    .. versionadded:: 24.2.0
+    """
+
+    #: Whether the message was sent rather than received.
+    sent: bool
+    #: The protocol version, for example :data:`TLS1_3_VERSION`.
+    version: int
+    #: The record content type: 20 (change_cipher_spec), 21 (alert) or 22
+    #: (handshake).
+    content_type: int
+    #: The handshake message type, for example 1 for ClientHello, or the
+    #: alert description, for example 40 for handshake_failure, or
+    #: :obj:`None`.
+    message_type: typing.Optional[int]
+    #: The alert level, 1 (warning) or 2 (fatal), or :obj:`None`.
+    alert_level: typing.Optional[int]
+    #: The message length in bytes.
+    length: int
+
+
+class ConnectionInfo(typing.NamedTuple):
+    """
+    The parameters negotiated by a connection, as returned by
+    :meth:`Connection.get_info`.
+
+    .. versionadded:: 24.2.0
+    """
+
+    #: The protocol version name, for example ``"TLSv1.3"``.
+    protocol: str
+    #: The cipher name, or :obj:`None` if no cipher is in use.
+    cipher_name: typing.Optional[str]
+    #: The number of secret bits of the cipher, or :obj:`None`.
+    cipher_bits: typing.Optional[int]
+    #: The protocol selected by ALPN, or ``b""``.
+    alpn_protocol: bytes
+    #: The server name sent by the client, or :obj:`None`.
+    server_name: typing.Optional[bytes]
+    #: Whether the session was resumed, as returned by
+    #: :meth:`Connection.session_reused`, or :obj:`None` if that cannot
+    #: tell.
+    session_reused: typing.Optional[bool]
+    #: The digest of the peer certificate in the format of
+    #: :meth:`OpenSSL.crypto.X509.digest`, or :obj:`None`.
+    peer_certificate_digest: typing.Optional[bytes]
+    #: The result of the peer certificate verification, see
+    #: :class:`X509VerificationCodes`.
+    verify_result: int
+
+
 class Context:
     """
     :class:`OpenSSL.SSL.Context` instances define the parameters for setting
@@ -855,6 +1342,17 @@ class Context:
         self._ocsp_data = None
         self._cookie_generate_helper = None
         self._cookie_verify_helper = None
+        self._msg_callback = None
+        self._msg_observers = []
+        self._hello_retry_requests = None
+        self._track_signature_algorithms = False
+        self._track_session_reuse = False
+        self._has_extra_chain_certs = False
+        self._message_recorder_size = 0
+        self._psk_server_helper = None
+        self._psk_client_helper = None
+        self._psk_server_callback = None
+        self._psk_keys = {}
 
         self.set_mode(_lib.SSL_MODE_ENABLE_PARTIAL_WRITE)
         if version is not None:
@@ -919,6 +1417,37 @@ class Context:
         if not load_result:
             _raise_current_error()
 
+    def load_verify_buffer(self, buffer):
+        """
+        Trust the certificates, and use the CRLs, in a buffer of PEM data,
+        like :meth:`load_verify_locations` does for a file.
+
+        The whole buffer is parsed before anything is added, so if it is
+        malformed the trusted certificates are left unchanged.
+
+        :param bytes buffer: The PEM encoded certificates and CRLs.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if not isinstance(buffer, bytes):
+            raise TypeError("buffer must be a byte string")
+
+        certificates = _read_pem_objects(
+            buffer, _lib.PEM_read_bio_X509, _gc_x509, Error
+        )
+        crls = _read_pem_objects(
+            buffer, _lib.PEM_read_bio_X509_CRL, _gc_x509_crl, Error
+        )
+        if not certificates and not crls:
+            raise Error([("PEM routines", "", "no certificates found")])
+
+        store = _lib.SSL_CTX_get_cert_store(self._context)
+        for certificate in certificates:
+            _openssl_assert(_lib.X509_STORE_add_cert(store, certificate) == 1)
+        for crl in crls:
+            _openssl_assert(_lib.X509_STORE_add_crl(store, crl) == 1)
+
     def _wrap_callback(self, callback):
         @wraps(callback)
         def wrapper(size, verify, userdata):
@@ -1053,6 +1582,74 @@ class Context:
         if not result:
             _raise_current_error()
 
+    def _use_certificate_chain(self, certificates, pkey=None):
+        """
+        Install *certificates*, the certificate of the context followed by
+        its chain, and its private key *pkey* if given.
+        """
+        # The extra chain certificates of a context can only be added to, so
+        # loading a new chain would keep sending the old intermediates.
+        if self._has_extra_chain_certs:
+            raise ValueError(
+                "The context already has extra chain certificates"
+            )
+
+        # Try the certificate and key on a connection first, so that the
+        # checks OpenSSL makes (the key matches the certificate, and is
+        # allowed at the security level of the context) cannot fail once the
+        # context has started to change.
+        ssl = _lib.SSL_new(self._context)
+        _openssl_assert(ssl != _ffi.NULL)
+        ssl = _ffi.gc(ssl, _lib.SSL_free)
+        if not _lib.SSL_use_certificate(ssl, certificates[0]):
+            _raise_current_error()
+        if pkey is not None and not _lib.SSL_use_PrivateKey(ssl, pkey):
+            _raise_current_error()
+
+        _openssl_assert(
+            _lib.SSL_CTX_use_certificate(self._context, certificates[0]) == 1
+        )
+        if pkey is not None:
+            _openssl_assert(
+                _lib.SSL_CTX_use_PrivateKey(self._context, pkey) == 1
+            )
+        for certificate in certificates[1:]:
+            _openssl_assert(
+                _lib.SSL_CTX_add_extra_chain_cert(self._context, certificate)
+                == 1
+            )
+            self._has_extra_chain_certs = True
+            # The context owns the certificate now.
+            _ffi.gc(certificate, None)
+
+    def use_certificate_chain_buffer(self, buffer):
+        """
+        Load a certificate chain from a buffer of PEM data, like
+        :meth:`use_certificate_chain_file` does from a file.
+
+        The first certificate is used as the certificate of the context and
+        the others are added to its chain, without copying any of them.  The
+        whole buffer is parsed and checked before anything is installed, so
+        if it is malformed the context is left unchanged.
+
+        The chain is added to the extra chain certificates of the context,
+        which cannot be replaced, so load a chain at most once per context,
+        and not after :meth:`add_extra_chain_cert`.  To change certificates,
+        use a new :class:`Context`.
+
+        :param bytes buffer: The PEM encoded certificates, starting with the
+            certificate of the context.  Other PEM blocks are ignored.
+        :raises ValueError: If the context already has extra chain
+            certificates.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if not isinstance(buffer, bytes):
+            raise TypeError("buffer must be a byte string")
+
+        self._use_certificate_chain(_read_pem_certificates(buffer))
+
     def use_certificate_file(self, certfile, filetype=FILETYPE_PEM):
         """
         Load a certificate from a file
@@ -1106,6 +1703,7 @@ class Context:
             # TODO: This is untested.
             _lib.X509_free(copy)
             _raise_current_error()
+        self._has_extra_chain_certs = True
 
     def _raise_passphrase_exception(self):
         if self._passphrase_helper is not None:
@@ -1137,6 +1735,86 @@ class Context:
         if not use_result:
             self._raise_passphrase_exception()
 
+    def _read_privatekey(self, buffer, filetype):
+        if self._passphrase_callback is None:
+            # An empty passphrase stops OpenSSL from prompting on the
+            # terminal for an encrypted key.
+            callback = _ffi.NULL
+            password = _ffi.new("char[]", b"")
+        else:
+            callback = self._passphrase_callback
+            password = _ffi.NULL
+        if filetype == FILETYPE_PEM:
+            pkey = _lib.PEM_read_bio_PrivateKey(
+                _new_mem_buf(buffer), _ffi.NULL, callback, password
+            )
+        elif filetype == FILETYPE_ASN1:
+            pkey = _lib.d2i_PrivateKey_bio(_new_mem_buf(buffer), _ffi.NULL)
+            if pkey == _ffi.NULL:
+                # Not an unencrypted key, so try an encrypted PKCS #8 one.
+                _lib.ERR_clear_error()
+                pkey = _lib.d2i_PKCS8PrivateKey_bio(
+                    _new_mem_buf(buffer), _ffi.NULL, callback, password
+                )
+        else:
+            raise ValueError("filetype must be FILETYPE_PEM or FILETYPE_ASN1")
+        if pkey == _ffi.NULL:
+            self._raise_passphrase_exception()
+        return _ffi.gc(pkey, _lib.EVP_PKEY_free)
+
+    def use_privatekey_buffer(self, buffer, filetype=FILETYPE_PEM):
+        """
+        Load a private key from a buffer, like :meth:`use_privatekey_file`
+        does from a file.
+
+        An encrypted key, in PEM or as encrypted PKCS #8 DER, is decrypted
+        with the passphrase from the callback given to :meth:`set_passwd_cb`.
+
+        :param bytes buffer: The encoded private key.  A PEM buffer may
+            contain other PEM blocks, which are ignored.
+        :param filetype: (optional) The encoding of the buffer, which is
+            either :const:`FILETYPE_PEM` or :const:`FILETYPE_ASN1`.  The
+            default is :const:`FILETYPE_PEM`.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if not isinstance(buffer, bytes):
+            raise TypeError("buffer must be a byte string")
+
+        pkey = self._read_privatekey(buffer, filetype)
+        if not _lib.SSL_CTX_use_PrivateKey(self._context, pkey):
+            self._raise_passphrase_exception()
+
+    def use_certificate_chain_and_key_buffer(self, buffer):
+        """
+        Load a certificate chain and its private key from one buffer of PEM
+        data, such as the concatenation of the files given to
+        :meth:`use_certificate_chain_file` and :meth:`use_privatekey_file`.
+
+        The certificates and the key are parsed and checked to match before
+        any of them is installed, so the context never holds a certificate
+        with the wrong key, and is left unchanged if anything is wrong.  As
+        with :meth:`use_certificate_chain_buffer`, load a chain at most once
+        per context.
+
+        :param bytes buffer: The PEM encoded certificates, starting with the
+            certificate of the context, and its private key.  An encrypted key
+            is decrypted with the passphrase from the callback given to
+            :meth:`set_passwd_cb`.
+        :raises ValueError: If the context already has extra chain
+            certificates.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if not isinstance(buffer, bytes):
+            raise TypeError("buffer must be a byte string")
+
+        certificates = _read_pem_certificates(buffer)
+        pkey = self._read_privatekey(buffer, FILETYPE_PEM)
+        self._use_certificate_chain(certificates, pkey)
+
     def use_privatekey(self, pkey):
         """
         Load a private key from a PKey object
@@ -1320,6 +1998,192 @@ class Context:
         """
         _lib.SSL_CTX_set_tmp_ecdh(self._context, curve._to_EC_KEY())
 
+    def track_hello_retry_requests(self):
+        """
+        Start counting the TLS 1.3 HelloRetryRequests sent or received by
+        connections subsequently created with this context.
+
+        This installs a message callback, which adds a little overhead to
+        every handshake.
+
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if self._hello_retry_requests is not None:
+            return
+        self._hello_retry_requests = 0
+
+        def observer(write_p, version, content_type, buf, length, ssl):
+            # A ServerHello handshake message whose random follows the 4 byte
+            # message header and 2 byte legacy version.
+            if content_type == _SSL3_RT_HANDSHAKE and length >= 38:
+                data = _ffi.buffer(buf, 38)
+                if data[0] == b"\x02" and data[6:38] == (
+                    _HELLO_RETRY_REQUEST_RANDOM
+                ):
+                    self._hello_retry_requests += 1
+
+        self._add_message_observer(observer)
+
+    @_requires_sigalgs
+    def set_sigalgs(self, sigalgs):
+        """
+        Set the signature algorithms to use, in order of preference.
+
+        This restricts and orders the algorithms offered in the
+        ``signature_algorithms`` extension and accepted from the peer.  For
+        example, a server whose certificate keys allow it may prefer the
+        cheaper ``"ed25519"`` and ``"ecdsa_secp256r1_sha256"`` over
+        ``"rsa_pss_rsae_sha256"``.
+
+        :param sigalgs: A list of signature algorithm names (``str``) in the
+            format understood by OpenSSL, for example ``"ed25519"``,
+            ``"rsa_pss_rsae_sha256"`` or ``"ECDSA+SHA256"``.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        sigalgs = list(sigalgs)
+        if not sigalgs:
+            raise ValueError("at least one signature algorithm must be given")
+
+        result = _lib.SSL_CTX_set1_sigalgs_list(
+            self._context, ":".join(sigalgs).encode("ascii")
+        )
+        if result != 1:
+            _raise_current_error()
+
+    def track_signature_algorithms(self):
+        """
+        Record the signature algorithm of the handshake signatures of
+        connections subsequently created with this context.  They are then
+        available from :meth:`Connection.get_signature_algorithm` and
+        :meth:`Connection.get_peer_signature_algorithm`.
+
+        This installs a message callback, which adds a little overhead to
+        every handshake.
+
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if self._track_signature_algorithms:
+            return
+        self._track_signature_algorithms = True
+
+        def observer(write_p, version, content_type, buf, length, ssl):
+            if content_type != _SSL3_RT_HANDSHAKE:
+                return
+            # Only look at the small messages carrying a signature.
+            first = _ffi.buffer(buf, 1)[0]
+            if first not in (b"\x0c", b"\x0f"):
+                return
+            scheme = _signature_scheme(version, _ffi.buffer(buf, length)[:])
+            conn = Connection._reverse_mapping.get(ssl)
+            if scheme is None or conn is None:
+                return
+            if write_p:
+                conn._signature_algorithm = scheme
+            else:
+                conn._peer_signature_algorithm = scheme
+
+        self._add_message_observer(observer)
+
+    def track_session_reuse(self):
+        """
+        Record how the handshakes of connections subsequently created with
+        this context went, so that :meth:`Connection.session_reused` can
+        infer whether they resumed a session when the OpenSSL binding in use
+        lacks ``SSL_session_reused``.
+
+        This installs a Python message callback, which runs for every
+        handshake message, so only call it when the binding lacks
+        ``SSL_session_reused`` and the answer is needed.
+
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if self._track_session_reuse:
+            return
+        self._track_session_reuse = True
+        self._add_message_observer(_observe_session_reuse)
+
+    def set_message_recorder(self, size=32):
+        """
+        Keep the last *size* handshake messages, alerts and change cipher
+        spec messages of every connection subsequently created with this
+        context, so that :meth:`Connection.get_recorded_messages` can tell
+        how a failed handshake went.
+
+        Only the type, direction and length of each message are kept, in a
+        bounded buffer per connection.  But OpenSSL calls back into Python
+        for every message, which costs up to about a quarter of the
+        handshakes per second of fast (ECDSA) handshakes.  Turn it on while
+        diagnosing failures rather than leaving it on for busy servers.
+
+        :param size: The number of messages to keep per connection, or ``0``
+            to stop recording, and calling back into Python if nothing else
+            needs the messages, for connections created afterwards.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if size < 0:
+            raise ValueError("size must not be negative")
+
+        self._message_recorder_size = size
+        if size == 0:
+            self._remove_message_observer(_record_message)
+        elif _record_message not in self._msg_observers:
+            self._add_message_observer(_record_message)
+
+    def _add_message_observer(self, observer):
+        """
+        Call *observer* with the arguments of OpenSSL's message callback,
+        minus the user data pointer, for every protocol message of every
+        connection subsequently created with this context.
+        """
+        self._msg_observers.append(observer)
+        if self._msg_callback is None:
+            observers = self._msg_observers
+
+            def wrapper(write_p, version, content_type, buf, length, ssl, arg):
+                for observer in observers:
+                    observer(write_p, version, content_type, buf, length, ssl)
+
+            self._msg_callback = _ffi.callback(
+                "void (*)(int, int, int, void *, size_t, SSL *, void *)",
+                wrapper,
+            )
+        _lib.SSL_CTX_set_msg_callback(self._context, self._msg_callback)
+
+    def _remove_message_observer(self, observer):
+        """
+        Stop calling *observer* for the messages of connections, and stop
+        OpenSSL calling back into Python for connections subsequently created
+        with this context if no observers remain.
+        """
+        if observer not in self._msg_observers:
+            return
+        self._msg_observers.remove(observer)
+        if not self._msg_observers:
+            # Existing connections keep the callback, which this context
+            # keeps alive, but it no longer has anything to call.
+            _lib.SSL_CTX_set_msg_callback(self._context, _ffi.NULL)
+
+    def get_hello_retry_request_count(self):
+        """
+        Get the number of HelloRetryRequests counted since
+        :meth:`track_hello_retry_requests` was called.
+
+        :return: The count, or :obj:`None` if they are not being counted.
+
+        .. versionadded:: 24.2.0
+        """
+        return self._hello_retry_requests
+
     def set_cipher_list(self, cipher_list):
         """
         Set the list of ciphers to be used in this context.
@@ -1714,6 +2578,251 @@ class Context:
             self._cookie_verify_helper.callback,
         )
 
+    @_requires_psk
+    def use_psk_identity_hint(self, hint):
+        """
+        Set the PSK identity hint a server sends to clients before TLS 1.3.
+        TLS 1.3 has no identity hints.
+
+        :param hint: The identity hint.
+        :type hint: :py:class:`bytes`
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if not isinstance(hint, bytes):
+            raise TypeError("hint must be a byte string.")
+
+        _openssl_assert(
+            _lib.SSL_CTX_use_psk_identity_hint(self._context, hint) == 1
+        )
+
+    @_requires_psk
+    def set_psk_keys(self, keys):
+        """
+        Set the pre-shared keys a server accepts, for handshakes without
+        certificates.  The keys are looked up by the identity a client offers
+        before any callback set with :meth:`set_psk_server_callback` is
+        called.
+
+        The table may be replaced at any time by calling this again; the new
+        keys apply to every subsequent handshake, including those of existing
+        :class:`Connection` objects.
+
+        With TLS 1.3 the keys are used with cipher suites based on SHA-256,
+        unless only cipher suites based on SHA-384 are enabled.  Before TLS
+        1.3 a PSK cipher suite has to be enabled with :meth:`set_cipher_list`.
+
+        :param keys: A mapping of identities to keys, both :py:class:`bytes`.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        keys = dict(keys)
+        for identity, key in keys.items():
+            if not isinstance(identity, bytes) or not isinstance(key, bytes):
+                raise TypeError("PSK identities and keys must be bytes.")
+
+        self._psk_keys = keys
+        self._install_psk_server_helper()
+
+    @_requires_psk
+    def set_psk_server_callback(self, callback):
+        """
+        Set a callback to find the pre-shared key for an identity a client
+        offers that is not in the table set with :meth:`set_psk_keys`.
+
+        :param callback: The callback function.  It will be invoked with two
+            arguments: the Connection and the identity, as
+            :py:class:`bytes`.  It must return the key as
+            :py:class:`bytes`, or ``None`` to reject the identity.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        self._psk_server_callback = callback
+        self._install_psk_server_helper()
+
+    def _find_psk(self, conn, identity):
+        key = self._psk_keys.get(identity)
+        if key is None and self._psk_server_callback is not None:
+            key = self._psk_server_callback(conn, identity)
+        return key
+
+    def _install_psk_server_helper(self):
+        if self._psk_server_helper is not None:
+            return
+
+        self._psk_server_helper = _PSKServerCallbackHelper(self._find_psk)
+        if self._psk_server_helper.callback is not None:
+            _lib.SSL_CTX_set_psk_find_session_callback(
+                self._context, self._psk_server_helper.callback
+            )
+        _lib.SSL_CTX_set_psk_server_callback(
+            self._context, self._psk_server_helper.legacy_callback
+        )
+
+    @_requires_psk
+    def set_psk_client_callback(self, callback):
+        """
+        Set a callback to choose the pre-shared key a client offers, for
+        handshakes without certificates.
+
+        With TLS 1.3 the key is used with cipher suites based on SHA-256,
+        unless only cipher suites based on SHA-384 are enabled or the server
+        chooses one in a HelloRetryRequest.  Before TLS 1.3 a PSK cipher
+        suite has to be enabled with :meth:`set_cipher_list`.
+
+        :param callback: The callback function.  It will be invoked with two
+            arguments: the Connection and the identity hint sent by the
+            server as :py:class:`bytes`, or ``None`` if there is none.  It
+            must return a tuple of the identity and the key, both
+            :py:class:`bytes`, or ``None`` to offer no PSK.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        self._psk_client_helper = _PSKClientCallbackHelper(callback)
+        if self._psk_client_helper.callback is not None:
+            _lib.SSL_CTX_set_psk_use_session_callback(
+                self._context, self._psk_client_helper.callback
+            )
+            if _observe_psk_hello_retry not in self._msg_observers:
+                self._add_message_observer(_observe_psk_hello_retry)
+        _lib.SSL_CTX_set_psk_client_callback(
+            self._context, self._psk_client_helper.legacy_callback
+        )
+
+
+# The default buffer size of the file objects returned by Connection.makefile.
+# This holds several maximum-sized TLS records.
+_MAKEFILE_BUFFER_SIZE = 65536
+
+
+class _ConnectionIO(io.RawIOBase):
+    """
+    Raw I/O over a :class:`Connection`, as returned by
+    :meth:`Connection.makefile` with ``buffering=0`` and wrapped by the
+    buffered streams it returns otherwise.
+    """
+
+    def __init__(self, connection, reading, writing):
+        super().__init__()
+        self._connection = connection
+        self._reading = reading
+        self._writing = writing
+
+    def readable(self):
+        self._checkClosed()
+        return self._reading
+
+    def writable(self):
+        self._checkClosed()
+        return self._writing
+
+    def fileno(self):
+        self._checkClosed()
+        return self._connection.fileno()
+
+    def readinto(self, b):
+        self._checkClosed()
+        self._checkReadable()
+
+        view = memoryview(b).cast("B")
+        if not len(view):
+            return 0
+
+        # Decrypt straight into the caller's buffer.
+        conn = self._connection
+        with _ffi.from_buffer("char[]", view, require_writable=True) as data:
+            result = _lib.SSL_read(conn._ssl, data, len(view))
+            try:
+                conn._raise_ssl_error(conn._ssl, result)
+            except (WantReadError, WantWriteError):
+                return None
+            except ZeroReturnError:
+                return 0
+        if conn._key_update_limit is not None:
+            conn._count_received(result)
+        return result
+
+    def write(self, b):
+        self._checkClosed()
+        self._checkWritable()
+        try:
+            return self._connection.send(b)
+        except (WantReadError, WantWriteError):
+            return None
+
+
+def _record_message(write_p, version, content_type, buf, length, ssl):
+    """
+    A message observer which appends the messages of connections created
+    after :meth:`Context.set_message_recorder` to their recorder.
+    """
+    # Skip the record header and inner content type pseudo messages.
+    if content_type > _SSL3_RT_HANDSHAKE:
+        return
+    conn = Connection._reverse_mapping.get(ssl)
+    if conn is None or conn._recorded_messages is None:
+        return
+    head = _ffi.buffer(buf, min(length, 2))[:]
+    conn._recorded_messages.append(
+        (write_p, version, content_type, head, length)
+    )
+
+
+def _observe_psk_hello_retry(write_p, version, content_type, buf, length, ssl):
+    """
+    A message observer which records, for the clients of a context with a
+    PSK client callback, the cipher suite chosen by a HelloRetryRequest.
+    """
+    # A received ServerHello handshake message with the HelloRetryRequest
+    # random and room for a session ID.
+    if write_p or content_type != _SSL3_RT_HANDSHAKE or length < 39:
+        return
+    if _ffi.buffer(buf, 1)[0] != b"\x02":
+        return
+    data = _ffi.buffer(buf, length)[:]
+    if data[6:38] != _HELLO_RETRY_REQUEST_RANDOM:
+        return
+    conn = Connection._reverse_mapping.get(ssl)
+    if conn is None:
+        return
+    # The cipher suite follows the session ID.
+    offset = 39 + data[38]
+    conn._psk_hello_retry_cipher = data[offset : offset + 2]
+
+
+def _observe_session_reuse(write_p, version, content_type, buf, length, ssl):
+    """
+    A message observer which records, for connections created after
+    :meth:`Context.track_session_reuse`, which side sent the ClientHello,
+    whether the server sent a Certificate and which side sent the first
+    Finished message of the handshake.
+    """
+    if content_type != _SSL3_RT_HANDSHAKE or length < 1:
+        return
+    message_type = _ffi.buffer(buf, 1)[0]
+    if message_type not in (b"\x01", b"\x0b", b"\x14"):
+        return
+    conn = Connection._reverse_mapping.get(ssl)
+    if conn is None:
+        return
+    if message_type == b"\x01":
+        # A ClientHello starts a new handshake.
+        conn._session_reuse_state = [bool(write_p), False, None]
+        return
+    state = conn._session_reuse_state
+    if state is None:
+        return
+    from_server = bool(write_p) != state[0]
+    if message_type == b"\x0b":
+        if from_server:
+            state[1] = True
+    elif state[2] is None:
+        state[2] = from_server
+
 
 class Connection:
     _reverse_mapping = WeakValueDictionary()
@@ -1745,6 +2854,11 @@ class Connection:
         # avoid them getting freed.
         self._alpn_select_callback_args = None
 
+        # Likewise for the TLS 1.3 PSK identity a client offers.
+        self._psk_identity = None
+        # The cipher suite of a HelloRetryRequest, to offer the PSK again with.
+        self._psk_hello_retry_cipher = None
+
         # Reference the verify_callback of the Context. This ensures that if
         # set_verify is called again after the SSL object has been created we
         # do not point to a dangling reference
@@ -1755,6 +2869,27 @@ class Connection:
         self._cookie_generate_helper = context._cookie_generate_helper
         self._cookie_verify_helper = context._cookie_verify_helper
 
+        self._signature_algorithm = None
+        self._peer_signature_algorithm = None
+
+        # What Context.track_session_reuse saw of the last handshake.
+        self._track_session_reuse = context._track_session_reuse
+        self._session_reuse_state = None
+
+        # The messages kept for get_recorded_messages.
+        if context._message_recorder_size:
+            self._recorded_messages = deque(
+                maxlen=context._message_recorder_size
+            )
+        else:
+            self._recorded_messages = None
+
+        # The automatic key update policy set by set_key_update_limit, and
+        # the bytes sent and received since the last key update.
+        self._key_update_limit = None
+        self._key_update_sent = 0
+        self._key_update_received = 0
+
         self._reverse_mapping[self._ssl] = self
 
         if socket is None:
@@ -1795,6 +2930,10 @@ class Connection:
             self._context._alpn_select_helper.raise_if_problem()
         if self._context._ocsp_helper is not None:
             self._context._ocsp_helper.raise_if_problem()
+        if self._context._psk_server_helper is not None:
+            self._context._psk_server_helper.raise_if_problem()
+        if self._context._psk_client_helper is not None:
+            self._context._psk_client_helper.raise_if_problem()
 
         error = _lib.SSL_get_error(ssl, result)
         if error == _lib.SSL_ERROR_WANT_READ:
@@ -2016,6 +3155,8 @@ class Connection:
 
             result = _lib.SSL_write(self._ssl, data, len(data))
             self._raise_ssl_error(self._ssl, result)
+            if self._key_update_limit is not None:
+                self._count_sent(result)
 
             return result
 
@@ -2048,6 +3189,8 @@ class Connection:
                 total_sent += result
                 left_to_send -= result
 
+            if self._key_update_limit is not None:
+                self._count_sent(total_sent)
             return total_sent
 
     def recv(self, bufsiz, flags=None):
@@ -2064,6 +3207,8 @@ class Connection:
             result = _lib.SSL_peek(self._ssl, buf, bufsiz)
         else:
             result = _lib.SSL_read(self._ssl, buf, bufsiz)
+            if self._key_update_limit is not None and result > 0:
+                self._count_received(result)
         self._raise_ssl_error(self._ssl, result)
         return _ffi.buffer(buf, result)[:]
 
@@ -2096,6 +3241,8 @@ class Connection:
             result = _lib.SSL_peek(self._ssl, buf, nbytes)
         else:
             result = _lib.SSL_read(self._ssl, buf, nbytes)
+            if self._key_update_limit is not None and result > 0:
+                self._count_received(result)
         self._raise_ssl_error(self._ssl, result)
 
         # This strange line is all to avoid a memory copy. The buffer protocol
@@ -2211,6 +3358,76 @@ class Connection:
         """
         return _lib.SSL_total_renegotiations(self._ssl)
 
+    @_requires_key_update
+    def key_update(self, request_peer=False):
+        """
+        Update the TLS 1.3 traffic keys this side sends with.  The KeyUpdate
+        message goes out with the next :meth:`send` or :meth:`do_handshake`.
+
+        Unlike :meth:`renegotiate`, this does not repeat the handshake, so it
+        is cheap enough to do regularly on long-lived connections.
+
+        :param request_peer: Whether to ask the peer to update the keys it
+            sends with as well.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if request_peer:
+            update_type = _lib.SSL_KEY_UPDATE_REQUESTED
+        else:
+            update_type = _lib.SSL_KEY_UPDATE_NOT_REQUESTED
+        if _lib.SSL_key_update(self._ssl, update_type) != 1:
+            _raise_current_error()
+        self._key_update_sent = 0
+        if request_peer:
+            self._key_update_received = 0
+
+    @_requires_key_update
+    def set_key_update_limit(self, limit):
+        """
+        Update the TLS 1.3 traffic keys automatically, keeping long-lived
+        connections well within the limits of their cipher.
+
+        Once *limit* bytes of application data have been sent since the last
+        key update, :meth:`send` and :meth:`sendall` call
+        :meth:`key_update`.  Once *limit* bytes have been received,
+        :meth:`recv` and :meth:`recv_into` ask the peer to update its keys.
+        Connections that did not negotiate TLS 1.3 are not affected.
+
+        :param limit: The number of bytes, or ``None`` to stop updating keys
+            automatically.
+        :return: None
+
+        .. versionadded:: 24.2.0
+        """
+        if limit is not None and limit <= 0:
+            raise ValueError("limit must be positive")
+        self._key_update_limit = limit
+
+    def _count_sent(self, count):
+        self._key_update_sent += count
+        if self._key_update_sent >= self._key_update_limit:
+            self._automatic_key_update(_lib.SSL_KEY_UPDATE_NOT_REQUESTED)
+
+    def _count_received(self, count):
+        self._key_update_received += count
+        if self._key_update_received >= self._key_update_limit:
+            self._automatic_key_update(_lib.SSL_KEY_UPDATE_REQUESTED)
+
+    def _automatic_key_update(self, update_type):
+        if _lib.SSL_version(self._ssl) != TLS1_3_VERSION:
+            return
+        # The data has already been sent or received, so do not fail the
+        # call if a key update cannot be scheduled right now (for example
+        # because one is still pending); the next call tries again.
+        if _lib.SSL_key_update(self._ssl, update_type) != 1:
+            _lib.ERR_clear_error()
+            return
+        self._key_update_sent = 0
+        if update_type == _lib.SSL_KEY_UPDATE_REQUESTED:
+            self._key_update_received = 0
+
     def connect(self, addr):
         """
         Call the :meth:`connect` method of the underlying socket and set up SSL
@@ -2382,16 +3599,58 @@ class Connection:
             result.append(pyname)
         return result
 
-    def makefile(self, *args, **kwargs):
-        """
-        The makefile() method is not implemented, since there is no dup
-        semantics for SSL connections
+    def makefile(
+        self,
+        mode="r",
+        buffering=None,
+        *,
+        encoding=None,
+        errors=None,
+        newline=None,
+    ):
+        """
+        Return a file object reading from and/or writing to the connection.
+
+        The arguments are interpreted as by :meth:`socket.socket.makefile`.
+        Buffered streams default to a 64 KiB buffer which ``SSL_read``
+        decrypts into directly.
+
+        On a non-blocking connection, reads return :obj:`None` and writes
+        raise :exc:`BlockingIOError` when OpenSSL wants to read or write on
+        the transport, as with a non-blocking socket.  A clean TLS shutdown by
+        the peer is reported as end of file.
+
+        Closing the file object does not shut down or close the connection.
+
+        .. versionchanged:: 24.2.0
+            This used to raise :exc:`NotImplementedError`.
+        """
+        if not set(mode) <= {"r", "w", "b"}:
+            raise ValueError(f"invalid mode {mode!r} (only r, w, b allowed)")
+        writing = "w" in mode
+        reading = "r" in mode or not writing
+        binary = "b" in mode
+
+        raw = _ConnectionIO(self, reading, writing)
+        if buffering is None or buffering < 0:
+            buffering = _MAKEFILE_BUFFER_SIZE
+        if buffering == 0:
+            if not binary:
+                raise ValueError("unbuffered streams must be binary")
+            return raw
+
+        if reading and writing:
+            buffer = io.BufferedRWPair(raw, raw, buffering)
+        elif reading:
+            buffer = io.BufferedReader(raw, buffering)
+        else:
+            buffer = io.BufferedWriter(raw, buffering)
+        if binary:
+            return buffer
 
-        :raise: NotImplementedError
-        """
-        raise NotImplementedError(
-            "Cannot make file object of OpenSSL.SSL.Connection"
-        )
+        text = io.TextIOWrapper(buffer, encoding, errors, newline)
+        text.mode = mode
+        return text
 
     def get_app_data(self):
         """
@@ -2796,6 +4055,191 @@ class Connection:
         version = _lib.SSL_version(self._ssl)
         return version
 
+    def get_recorded_messages(self):
+        """
+        Get the most recent handshake messages, alerts and change cipher
+        spec messages this connection sent or received, oldest first.
+
+        Messages are only recorded if :meth:`Context.set_message_recorder`
+        was called before this connection was created.
+
+        :return: A list of :class:`RecordedMessage`.
+
+        .. versionadded:: 24.2.0
+        """
+        if self._recorded_messages is None:
+            return []
+
+        result = []
+        for write_p, version, content_type, head, length in list(
+            self._recorded_messages
+        ):
+            message_type = alert_level = None
+            if content_type == _SSL3_RT_HANDSHAKE and head:
+                message_type = head[0]
+            elif content_type == _SSL3_RT_ALERT and len(head) == 2:
+                alert_level, message_type = head[0], head[1]
+            result.append(
+                RecordedMessage(
+                    sent=bool(write_p),
+                    version=version,
+                    content_type=content_type,
+                    message_type=message_type,
+                    alert_level=alert_level,
+                    length=length,
+                )
+            )
+        return result
+
+    def session_reused(self):
+        """
+        Tell whether the last handshake resumed a session rather than
+        negotiating a new one.
+
+        OpenSSL answers this itself if the binding in use has
+        ``SSL_session_reused``, which no ``cryptography`` release before 43
+        binds.  With those releases this is not a native check: the answer
+        is inferred in Python from the handshake messages recorded by
+        :meth:`Context.track_session_reuse`.  A TLS 1.3 server sends no
+        certificate when it resumes a session, and only in a resumed
+        handshake does an earlier version's server send its Finished message
+        first.
+
+        :return: :data:`True` if the session was resumed, :data:`False` if
+            not or if no handshake has completed.
+        :raises NotImplementedError: If the binding lacks
+            ``SSL_session_reused`` and :meth:`Context.track_session_reuse`
+            was not called before this connection was created.
+
+        .. versionadded:: 24.2.0
+        """
+        # Not every supported cryptography release binds SSL_session_reused.
+        session_reused = getattr(_lib, "SSL_session_reused", None)
+        if session_reused is not None:
+            return bool(session_reused(self._ssl))
+        if not self._track_session_reuse:
+            raise NotImplementedError(
+                "SSL_session_reused is not available; call "
+                "Context.track_session_reuse before creating the connection"
+            )
+
+        state = self._session_reuse_state
+        if state is None or state[2] is None:
+            return False
+        _, server_certificate, server_finished_first = state
+        if _lib.SSL_version(self._ssl) == TLS1_3_VERSION:
+            return not server_certificate
+        return server_finished_first
+
+    def get_info(self, digest_name="sha256"):
+        """
+        Retrieve all the parameters negotiated by the connection at once.
+
+        This is cheaper than calling the individual getters, for example to
+        write an access log entry per connection.
+
+        :param digest_name: The name of the digest algorithm used to
+            fingerprint the peer certificate.
+        :return: The negotiated parameters.
+        :rtype: :class:`ConnectionInfo`
+
+        .. versionadded:: 24.2.0
+        """
+        digest = _lib.EVP_get_digestbyname(_byte_string(digest_name))
+        if digest == _ffi.NULL:
+            raise ValueError("No such digest method")
+
+        cipher = _lib.SSL_get_current_cipher(self._ssl)
+        if cipher == _ffi.NULL:
+            cipher_name = cipher_bits = None
+        else:
+            cipher_name = _ffi.string(_lib.SSL_CIPHER_get_name(cipher))
+            cipher_name = cipher_name.decode("utf-8")
+            cipher_bits = _lib.SSL_CIPHER_get_bits(cipher, _ffi.NULL)
+
+        data = _ffi.new("unsigned char **")
+        data_len = _ffi.new("unsigned int *")
+        _lib.SSL_get0_alpn_selected(self._ssl, data, data_len)
+        alpn_protocol = _ffi.buffer(data[0], data_len[0])[:]
+
+        server_name = _lib.SSL_get_servername(
+            self._ssl, _lib.TLSEXT_NAMETYPE_host_name
+        )
+        server_name = (
+            None if server_name == _ffi.NULL else _ffi.string(server_name)
+        )
+
+        try:
+            session_reused = self.session_reused()
+        except NotImplementedError:
+            session_reused = None
+
+        peer_certificate_digest = None
+        cert = _lib.SSL_get_peer_certificate(self._ssl)
+        if cert != _ffi.NULL:
+            try:
+                result_buffer = _ffi.new(
+                    "unsigned char[]", _lib.EVP_MAX_MD_SIZE
+                )
+                result_length = _ffi.new("unsigned int[]", 1)
+                result_length[0] = len(result_buffer)
+                result = _lib.X509_digest(
+                    cert, digest, result_buffer, result_length
+                )
+                _openssl_assert(result == 1)
+            finally:
+                _lib.X509_free(cert)
+            hexed = _ffi.buffer(result_buffer, result_length[0])[:].hex()
+            hexed = hexed.upper().encode("ascii")
+            peer_certificate_digest = b":".join(
+                hexed[i : i + 2] for i in range(0, len(hexed), 2)
+            )
+
+        return ConnectionInfo(
+            protocol=_ffi.string(_lib.SSL_get_version(self._ssl)).decode(
+                "utf-8"
+            ),
+            cipher_name=cipher_name,
+            cipher_bits=cipher_bits,
+            alpn_protocol=alpn_protocol,
+            server_name=server_name,
+            session_reused=session_reused,
+            peer_certificate_digest=peer_certificate_digest,
+            verify_result=_lib.SSL_get_verify_result(self._ssl),
+        )
+
+    def get_signature_algorithm(self):
+        """
+        Get the signature algorithm this side used to sign the handshake.
+
+        This is only recorded if :meth:`Context.track_signature_algorithms`
+        was called before the connection was created.
+
+        :return: The name of the signature algorithm, for example
+            ``"rsa_pss_rsae_sha256"``, or :obj:`None` if no signature was
+            made or it was not recorded.
+        :rtype: :class:`str` or :class:`NoneType`
+
+        .. versionadded:: 24.2.0
+        """
+        return self._signature_algorithm
+
+    def get_peer_signature_algorithm(self):
+        """
+        Get the signature algorithm the peer used to sign the handshake.
+
+        This is only recorded if :meth:`Context.track_signature_algorithms`
+        was called before the connection was created.
+
+        :return: The name of the signature algorithm, for example
+            ``"ecdsa_secp256r1_sha256"``, or :obj:`None` if no signature was
+            received or it was not recorded.
+        :rtype: :class:`str` or :class:`NoneType`
+
+        .. versionadded:: 24.2.0
+        """
+        return self._peer_signature_algorithm
+
     @_requires_alpn
     def set_alpn_protos(self, protos):
         """
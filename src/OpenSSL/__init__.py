@@ -5,7 +5,9 @@
 pyOpenSSL - A simple wrapper around the OpenSSL library
 """
 
-from OpenSSL import SSL, crypto
+import importlib
+import typing
+
 from OpenSSL.version import (
     __author__,
     __copyright__,
@@ -29,3 +31,18 @@ __all__ = [
     "__uri__",
     "__version__",
 ]
+
+
+if typing.TYPE_CHECKING:
+    from OpenSSL import SSL, crypto
+else:
+
+    def __getattr__(name):
+        # Import the submodules on first use so that programs which only
+        # need one of them do not pay for loading the other.
+        if name in ("SSL", "crypto"):
+            return importlib.import_module(f"OpenSSL.{name}")
+        raise AttributeError(f"module 'OpenSSL' has no attribute {name!r}")
+
+    def __dir__():
+        return sorted(set(globals()) | set(__all__))
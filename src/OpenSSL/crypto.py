@@ -1,13 +1,18 @@
 import calendar
 import datetime
 import functools
+import os
+import time
 import typing
 from base64 import b16encode
+from concurrent.futures import ThreadPoolExecutor
 from functools import partial
 from os import PathLike
 from typing import (
+    IO,
     Any,
     Callable,
+    Dict,
     Iterable,
     List,
     NoReturn,
@@ -16,10 +21,11 @@ from typing import (
     Set,
     Tuple,
     Type,
+    TypeVar,
     Union,
 )
 
-from cryptography import utils, x509
+from cryptography import utils
 from cryptography.hazmat.primitives.asymmetric import (
     dsa,
     ec,
@@ -53,6 +59,11 @@ from OpenSSL._util import (
     text_to_bytes_and_warn as _text_to_bytes_and_warn,
 )
 
+if typing.TYPE_CHECKING:
+    # Importing cryptography.x509 is expensive and only a few functions need
+    # it at runtime, so they import it themselves.
+    from cryptography import x509
+
 __all__ = [
     "FILETYPE_PEM",
     "FILETYPE_ASN1",
@@ -69,22 +80,34 @@ __all__ = [
     "X509",
     "X509StoreFlags",
     "X509Store",
+    "X509IntermediatePool",
+    "X509LazyStore",
     "X509StoreContextError",
     "X509StoreContext",
     "load_certificate",
     "dump_certificate",
+    "load_certificate_batch",
+    "dump_certificate_batch",
+    "load_certificates",
+    "digest_certificates",
+    "verify_certificates",
+    "find_expiring_certificates",
     "dump_publickey",
     "dump_privatekey",
     "Revoked",
     "CRL",
     "load_publickey",
     "load_privatekey",
+    "load_privatekeys",
     "dump_certificate_request",
     "load_certificate_request",
+    "CertificateRequestInfo",
+    "validate_certificate_requests",
     "sign",
     "verify",
     "dump_crl",
     "load_crl",
+    "write_crl",
 ]
 
 
@@ -161,6 +184,48 @@ def _bio_to_string(bio: Any) -> bytes:
     return _ffi.buffer(result_buffer[0], buffer_length)[:]
 
 
+def _map_in_threads(
+    func: Callable[[Any], Any],
+    items: Sequence[Any],
+    max_workers: Optional[int],
+) -> List[Any]:
+    """
+    Apply *func* to every element of *items* using up to *max_workers*
+    threads and return the results in input order.
+
+    The items are split into one contiguous chunk per thread.  cffi drops the
+    GIL for the duration of every OpenSSL call, so the expensive parts of
+    *func* run concurrently.  If *func* raises, the exception for the
+    earliest failing item is propagated.
+    """
+    if max_workers is None:
+        max_workers = os.cpu_count() or 1
+    if max_workers < 1:
+        raise ValueError("max_workers must be at least 1")
+
+    workers = min(max_workers, len(items))
+    if workers <= 1:
+        return [func(item) for item in items]
+
+    size, extra = divmod(len(items), workers)
+    chunks = []
+    start = 0
+    for i in range(workers):
+        end = start + size + (1 if i < extra else 0)
+        chunks.append(items[start:end])
+        start = end
+
+    def run(chunk: Sequence[Any]) -> List[Any]:
+        return [func(item) for item in chunk]
+
+    with ThreadPoolExecutor(max_workers=workers) as executor:
+        futures = [executor.submit(run, chunk) for chunk in chunks]
+        result = []
+        for future in futures:
+            result.extend(future.result())
+    return result
+
+
 def _set_asn1_time(boundary: Any, when: bytes) -> None:
     """
     The the time value of an ASN1 time object.
@@ -246,6 +311,36 @@ def _get_asn1_time(timestamp: Any) -> Optional[bytes]:
             return string_result
 
 
+def _get_asn1_timestamp(timestamp: Any) -> Optional[int]:
+    """
+    Retrieve the time value of an ASN1 time object as seconds since the epoch.
+
+    @param timestamp: An ASN1_TIME* from which the time value will be
+        retrieved.
+
+    @return: The time value from C{timestamp} as an L{int}.  Or C{None} if the
+        object contains no time value.
+    """
+    when = _get_asn1_time(timestamp)
+    if when is None:
+        return None
+    # ASN1_TIME_set_string and the DER decoder only accept the
+    # YYYYMMDDhhmmssZ form for GeneralizedTime, so the fields can be sliced
+    # out directly instead of going through strptime.
+    if len(when) != 15 or when[14:] != b"Z":
+        raise ValueError(f"Unsupported time format: {when!r}")
+    return calendar.timegm(
+        (
+            int(when[0:4]),
+            int(when[4:6]),
+            int(when[6:8]),
+            int(when[8:10]),
+            int(when[10:12]),
+            int(when[12:14]),
+        )
+    )
+
+
 class _X509NameInvalidator:
     def __init__(self) -> None:
         self._names: List[X509Name] = []
@@ -266,12 +361,57 @@ class PKey:
 
     _only_public = False
     _initialized = True
+    _pickle_private = False
 
     def __init__(self) -> None:
         pkey = _lib.EVP_PKEY_new()
         self._pkey = _ffi.gc(pkey, _lib.EVP_PKEY_free)
         self._initialized = False
 
+    def __reduce__(self) -> Tuple[Any, Tuple[int, bytes]]:
+        """
+        Pickle as DER.
+
+        Public keys are always picklable.  Pickling a key pair raises
+        :py:exc:`TypeError` unless it was explicitly allowed with
+        :py:meth:`set_private_pickling`, since the pickle then carries the
+        unencrypted private key.
+        """
+        if not self._initialized:
+            raise TypeError("cannot pickle an uninitialized PKey")
+
+        if self._only_public:
+            return (
+                load_publickey,
+                (FILETYPE_ASN1, dump_publickey(FILETYPE_ASN1, self)),
+            )
+
+        if not self._pickle_private:
+            raise TypeError(
+                "pickling a private key must be enabled with "
+                "set_private_pickling(True)"
+            )
+        return (
+            load_privatekey,
+            (FILETYPE_ASN1, dump_privatekey(FILETYPE_ASN1, self)),
+        )
+
+    def set_private_pickling(self, allowed: bool) -> None:
+        """
+        Allow or forbid pickling the private part of this key.
+
+        The pickle contains the unencrypted DER encoding of the key, so only
+        enable this when the pickle never leaves trusted memory (for example
+        when handing keys to a local process pool).  The setting is not
+        carried over to the unpickled key.
+
+        :param bool allowed: Whether pickling this key pair is allowed.
+        :return: ``None``
+
+        .. versionadded:: 24.2.0
+        """
+        self._pickle_private = bool(allowed)
+
     def to_cryptography_key(self) -> _Key:
         """
         Export as a ``cryptography`` key.
@@ -736,13 +876,7 @@ class X509Name:
         :return: The DER encoded form of this name.
         :rtype: :py:class:`bytes`
         """
-        result_buffer = _ffi.new("unsigned char**")
-        encode_result = _lib.i2d_X509_NAME(self._name, result_buffer)
-        _openssl_assert(encode_result >= 0)
-
-        string_result = _ffi.buffer(result_buffer[0], encode_result)[:]
-        _lib.OPENSSL_free(result_buffer[0])
-        return string_result
+        return _get_name_der(self._name)
 
     def get_components(self) -> List[Tuple[bytes, bytes]]:
         """
@@ -962,7 +1096,16 @@ class X509Req:
         # Default to version 0.
         self.set_version(0)
 
-    def to_cryptography(self) -> x509.CertificateSigningRequest:
+    def __reduce__(self) -> Tuple[Any, Tuple[int, bytes]]:
+        """
+        Pickle as DER.
+        """
+        return (
+            load_certificate_request,
+            (FILETYPE_ASN1, dump_certificate_request(FILETYPE_ASN1, self)),
+        )
+
+    def to_cryptography(self) -> "x509.CertificateSigningRequest":
         """
         Export as a ``cryptography`` certificate signing request.
 
@@ -978,7 +1121,7 @@ class X509Req:
 
     @classmethod
     def from_cryptography(
-        cls, crypto_req: x509.CertificateSigningRequest
+        cls, crypto_req: "x509.CertificateSigningRequest"
     ) -> "X509Req":
         """
         Construct based on a ``cryptography`` *crypto_req*.
@@ -990,6 +1133,8 @@ class X509Req:
 
         .. versionadded:: 17.1.0
         """
+        from cryptography import x509
+
         if not isinstance(crypto_req, x509.CertificateSigningRequest):
             raise TypeError("Must be a certificate signing request")
 
@@ -1193,7 +1338,16 @@ class X509:
         cert._subject_invalidator = _X509NameInvalidator()
         return cert
 
-    def to_cryptography(self) -> x509.Certificate:
+    def __reduce__(self) -> Tuple[Any, Tuple[int, bytes]]:
+        """
+        Pickle as DER.
+        """
+        return (
+            load_certificate,
+            (FILETYPE_ASN1, dump_certificate(FILETYPE_ASN1, self)),
+        )
+
+    def to_cryptography(self) -> "x509.Certificate":
         """
         Export as a ``cryptography`` certificate.
 
@@ -1207,7 +1361,7 @@ class X509:
         return load_der_x509_certificate(der)
 
     @classmethod
-    def from_cryptography(cls, crypto_cert: x509.Certificate) -> "X509":
+    def from_cryptography(cls, crypto_cert: "x509.Certificate") -> "X509":
         """
         Construct based on a ``cryptography`` *crypto_cert*.
 
@@ -1218,6 +1372,8 @@ class X509:
 
         .. versionadded:: 17.1.0
         """
+        from cryptography import x509
+
         if not isinstance(crypto_cert, x509.Certificate):
             raise TypeError("Must be a certificate")
 
@@ -1460,15 +1616,10 @@ class X509:
         :return: ``True`` if the certificate has expired, ``False`` otherwise.
         :rtype: bool
         """
-        time_bytes = self.get_notAfter()
-        if time_bytes is None:
+        not_after = self.get_notAfter_timestamp()
+        if not_after is None:
             raise ValueError("Unable to determine notAfter")
-        time_string = time_bytes.decode("utf-8")
-        not_after = datetime.datetime.strptime(time_string, "%Y%m%d%H%M%SZ")
-
-        UTC = datetime.timezone.utc
-        utcnow = datetime.datetime.now(UTC).replace(tzinfo=None)
-        return not_after < utcnow
+        return not_after < int(time.time())
 
     def _get_boundary_time(self, which: Any) -> Optional[bytes]:
         return _get_asn1_time(which(self._x509))
@@ -1486,6 +1637,30 @@ class X509:
         """
         return self._get_boundary_time(_lib.X509_getm_notBefore)
 
+    def get_notBefore_timestamp(self) -> Optional[int]:
+        """
+        Get the time at which the certificate starts being valid, in seconds
+        since the epoch.
+
+        :return: A POSIX timestamp, or ``None`` if there is none.
+        :rtype: int or NoneType
+
+        .. versionadded:: 24.2.0
+        """
+        return _get_asn1_timestamp(_lib.X509_getm_notBefore(self._x509))
+
+    def get_notAfter_timestamp(self) -> Optional[int]:
+        """
+        Get the time at which the certificate stops being valid, in seconds
+        since the epoch.
+
+        :return: A POSIX timestamp, or ``None`` if there is none.
+        :rtype: int or NoneType
+
+        .. versionadded:: 24.2.0
+        """
+        return _get_asn1_timestamp(_lib.X509_getm_notAfter(self._x509))
+
     def _set_boundary_time(
         self, which: Callable[..., Any], when: bytes
     ) -> None:
@@ -1693,9 +1868,103 @@ class X509Store:
     :class:`X509StoreContext`.
     """
 
+    # Stores wrapping the store of an SSL Context are created without calling
+    # __init__ and their contents are not known, so they cannot be replicated.
+    _replicable = False
+    _modified = False
+    # Once replicate_per_thread has been called, the calls replicas repeat on
+    # their X509_STORE*, as (function, arguments) pairs, and the replicas not
+    # in use by a verification.
+    _snapshot: Optional[List[Tuple[Callable[..., Any], Tuple[Any, ...]]]] = (
+        None
+    )
+    _replicas: Optional[List[Any]] = None
+    _frozen = False
+
     def __init__(self) -> None:
         store = _lib.X509_STORE_new()
         self._store = _ffi.gc(store, _lib.X509_STORE_free)
+        self._replicable = True
+
+    def _modify(self) -> None:
+        """
+        Check that the store may still be modified.
+        """
+        if self._frozen:
+            raise ValueError("A store replicated per thread is read-only")
+        self._modified = True
+
+    def _record(self, function: Callable[..., Any], *args: Any) -> None:
+        """
+        Have replicas call *function* with their X509_STORE* and *args*, if
+        the store is replicated.
+        """
+        if self._snapshot is not None:
+            self._snapshot.append((function, args))
+
+    def replicate_per_thread(self) -> None:
+        """
+        Give every thread which verifies certificates with this store its own
+        copy of it.
+
+        OpenSSL locks a store for every issuer lookup, so threads verifying
+        with the same store contend for that lock.  Call this before adding
+        anything to the store.  Once the store is first used with
+        :class:`X509StoreContext`, every concurrent verification gets a
+        replica of it, replicas are kept for reuse as long as the store, and
+        the store can no longer be modified.
+
+        Replicas share the certificates and CRLs of the store rather than
+        reading them again.  Only the *capath* directories of
+        :meth:`load_locations` are looked up by each replica.
+
+        :raises ValueError: If the store was not created with
+            :class:`X509Store`, for example one returned by
+            :meth:`OpenSSL.SSL.Context.get_cert_store`, or if something has
+            already been added to it.
+        :return: ``None``
+
+        .. versionadded:: 24.2.0
+        """
+        if not self._replicable:
+            raise ValueError("Only stores created by X509Store can replicate")
+        if self._snapshot is not None:
+            return
+        if self._modified:
+            raise ValueError(
+                "replicate_per_thread must be called on an empty store"
+            )
+        self._snapshot = []
+        self._replicas = []
+
+    def _new_replica(self) -> Any:
+        """
+        Return a new X509_STORE* with the contents of this store.
+        """
+        store = _lib.X509_STORE_new()
+        _openssl_assert(store != _ffi.NULL)
+        store = _ffi.gc(store, _lib.X509_STORE_free)
+        for function, args in self._snapshot or []:
+            if not function(store, *args):
+                _raise_current_error()
+        return store
+
+    def _acquire_store(self) -> Any:
+        """
+        Return the X509_STORE* to verify one certificate with, which must be
+        handed back with :meth:`_release_store` afterwards.
+        """
+        if self._replicas is None:
+            return self._store
+        self._frozen = True
+        try:
+            return self._replicas.pop()
+        except IndexError:
+            return self._new_replica()
+
+    def _release_store(self, store: Any) -> None:
+        if self._replicas is not None and store is not self._store:
+            self._replicas.append(store)
 
     def add_cert(self, cert: X509) -> None:
         """
@@ -1716,11 +1985,13 @@ class X509Store:
         if not isinstance(cert, X509):
             raise TypeError()
 
+        self._modify()
         res = _lib.X509_STORE_add_cert(self._store, cert._x509)
         _openssl_assert(res == 1)
+        self._record(_lib.X509_STORE_add_cert, cert._x509)
 
     def add_crl(
-        self, crl: Union["_CRLInternal", x509.CertificateRevocationList]
+        self, crl: Union["_CRLInternal", "x509.CertificateRevocationList"]
     ) -> None:
         """
         Add a certificate revocation list to this store.
@@ -1736,6 +2007,8 @@ class X509Store:
         :return: ``None`` if the certificate revocation list was added
             successfully.
         """
+        from cryptography import x509
+
         if isinstance(crl, x509.CertificateRevocationList):
             from cryptography.hazmat.primitives.serialization import Encoding
 
@@ -1753,7 +2026,9 @@ class X509Store:
                 "cryptography.x509.CertificateRevocationList"
             )
 
+        self._modify()
         _openssl_assert(_lib.X509_STORE_add_crl(self._store, crl) != 0)
+        self._record(_lib.X509_STORE_add_crl, crl)
 
     def set_flags(self, flags: int) -> None:
         """
@@ -1777,7 +2052,9 @@ class X509Store:
             See :class:`X509StoreFlags` for available constants.
         :return: ``None`` if the verification flags were successfully set.
         """
+        self._modify()
         _openssl_assert(_lib.X509_STORE_set_flags(self._store, flags) != 0)
+        self._record(_lib.X509_STORE_set_flags, flags)
 
     def set_time(self, vfy_time: datetime.datetime) -> None:
         """
@@ -1795,6 +2072,7 @@ class X509Store:
         :param datetime vfy_time: The verification time to set on this store.
         :return: ``None`` if the verification time was successfully set.
         """
+        self._modify()
         param = _lib.X509_VERIFY_PARAM_new()
         param = _ffi.gc(param, _lib.X509_VERIFY_PARAM_free)
 
@@ -1802,6 +2080,7 @@ class X509Store:
             param, calendar.timegm(vfy_time.timetuple())
         )
         _openssl_assert(_lib.X509_STORE_set1_param(self._store, param) != 0)
+        self._record(_lib.X509_STORE_set1_param, param)
 
     def load_locations(
         self, cafile: StrOrBytesPath, capath: Optional[StrOrBytesPath] = None
@@ -1836,6 +2115,7 @@ class X509Store:
             or the locations could not be set for any reason.
 
         """
+        self._modify()
         if cafile is None:
             cafile = _ffi.NULL
         else:
@@ -1851,6 +2131,389 @@ class X509Store:
         )
         if not load_result:
             _raise_current_error()
+        if self._snapshot is not None:
+            self._record_locations(cafile, capath)
+
+    def _record_locations(self, cafile: Any, capath: Any) -> None:
+        """
+        Have replicas repeat a successful :meth:`load_locations` with the
+        certificates and CRLs read from *cafile* now, and their own lookup in
+        *capath*, which only reads files when a verification needs them.
+        """
+        if cafile != _ffi.NULL:
+            with open(cafile, "rb") as f:
+                data = f.read()
+            if b"-----BEGIN TRUSTED CERTIFICATE" in data:
+                # PEM_read_bio_X509 skips these, so load the file again.
+                self._record(_lib.X509_STORE_load_locations, cafile, _ffi.NULL)
+            else:
+                for cert in _read_pem_objects(
+                    data,
+                    _lib.PEM_read_bio_X509,
+                    lambda x509: _ffi.gc(x509, _lib.X509_free),
+                ):
+                    self._record(_lib.X509_STORE_add_cert, cert)
+                for crl in _read_pem_objects(
+                    data,
+                    _lib.PEM_read_bio_X509_CRL,
+                    lambda crl: _ffi.gc(crl, _lib.X509_CRL_free),
+                ):
+                    self._record(_lib.X509_STORE_add_crl, crl)
+        if capath != _ffi.NULL:
+            self._record(_lib.X509_STORE_load_locations, _ffi.NULL, capath)
+
+
+_NID_SUBJECT_KEY_IDENTIFIER = 82
+_NID_AUTHORITY_KEY_IDENTIFIER = 90
+
+
+def _der_value(data: bytes, offset: int) -> Tuple[int, int, int]:
+    """
+    Parse the DER header at *offset* in *data* and return the tag and the
+    start and end offsets of the value.
+    """
+    if offset + 2 > len(data):
+        raise ValueError("truncated DER")
+    tag = data[offset]
+    length = data[offset + 1]
+    start = offset + 2
+    if length & 0x80:
+        count = length & 0x7F
+        length = int.from_bytes(data[start : start + count], "big")
+        start += count
+    if start + length > len(data):
+        raise ValueError("truncated DER")
+    return tag, start, start + length
+
+
+def _get_key_identifier(x509: Any, nid: int) -> Optional[bytes]:
+    """
+    Retrieve the key identifier from the subject or authority key identifier
+    extension of a certificate.
+
+    @param x509: An X509* to look in.
+    @param nid: Which extension to look at.
+
+    @return: The key identifier, or C{None} if the certificate has none or it
+        cannot be parsed.
+    """
+    for index in range(_lib.X509_get_ext_count(x509)):
+        extension = _lib.X509_get_ext(x509, index)
+        if _lib.OBJ_obj2nid(_lib.X509_EXTENSION_get_object(extension)) != nid:
+            continue
+        octets = _ffi.cast(
+            "ASN1_STRING*", _lib.X509_EXTENSION_get_data(extension)
+        )
+        data = _ffi.buffer(
+            _lib.ASN1_STRING_get0_data(octets), _lib.ASN1_STRING_length(octets)
+        )[:]
+        try:
+            tag, start, end = _der_value(data, 0)
+            if nid == _NID_SUBJECT_KEY_IDENTIFIER:
+                # SubjectKeyIdentifier ::= OCTET STRING
+                return data[start:end] if tag == 0x04 else None
+            # AuthorityKeyIdentifier ::= SEQUENCE {
+            #     keyIdentifier [0] IMPLICIT OCTET STRING OPTIONAL, ... }
+            if tag != 0x30 or start == end:
+                return None
+            tag, start, end = _der_value(data, start)
+            return data[start:end] if tag == 0x80 else None
+        except ValueError:
+            return None
+    return None
+
+
+class X509IntermediatePool:
+    """
+    A pool of untrusted intermediate certificates to build certificate chains
+    from.
+
+    Passing a long list of intermediates as the *chain* of an
+    :class:`X509StoreContext` copies every one of them into each
+    verification.  A pool indexes its certificates by subject name hash and
+    subject key identifier instead, so that only the certificates which can
+    be on the path from the verified certificate to a trusted one are handed
+    to OpenSSL.  Pass the pool as the *chain* of :class:`X509StoreContext` or
+    :func:`verify_certificates`.
+
+    Certificates in the pool are not trusted; the chain must still end at a
+    certificate in the :class:`X509Store`.  A pool may be shared between
+    threads as long as no certificates are added to it while verifying.
+
+    :param certificates: The certificates to start the pool with.
+    :type certificates: An iterable of :class:`X509`
+
+    .. versionadded:: 24.2.0
+    """
+
+    def __init__(self, certificates: Iterable[X509] = ()) -> None:
+        self._by_subject: Dict[int, List[X509]] = {}
+        self._by_key_id: Dict[bytes, List[X509]] = {}
+        self._count = 0
+        for cert in certificates:
+            self.add_certificate(cert)
+
+    def __len__(self) -> int:
+        return self._count
+
+    def add_certificate(self, cert: X509) -> None:
+        """
+        Add an intermediate certificate to the pool.
+
+        :param X509 cert: The certificate to add.
+        :return: ``None``
+        """
+        if not isinstance(cert, X509):
+            raise TypeError("cert must be an X509 instance")
+
+        subject = _lib.X509_get_subject_name(cert._x509)
+        self._by_subject.setdefault(_lib.X509_NAME_hash(subject), []).append(
+            cert
+        )
+        key_id = _get_key_identifier(cert._x509, _NID_SUBJECT_KEY_IDENTIFIER)
+        if key_id is not None:
+            self._by_key_id.setdefault(key_id, []).append(cert)
+        self._count += 1
+
+    def _find_issuers(self, x509: Any) -> List[X509]:
+        issuer = _lib.X509_get_issuer_name(x509)
+
+        def matching(candidates: List[X509]) -> List[X509]:
+            return [
+                candidate
+                for candidate in candidates
+                if _lib.X509_NAME_cmp(
+                    _lib.X509_get_subject_name(candidate._x509), issuer
+                )
+                == 0
+            ]
+
+        key_id = _get_key_identifier(x509, _NID_AUTHORITY_KEY_IDENTIFIER)
+        if key_id is not None:
+            # A key identifier is only a hint: the same key may have been
+            # certified under another name, so fall back to the name index.
+            issuers = matching(self._by_key_id.get(key_id, []))
+            if issuers:
+                return issuers
+        return matching(self._by_subject.get(_lib.X509_NAME_hash(issuer), []))
+
+    def _find_path(self, cert: X509) -> List[X509]:
+        """
+        Return every certificate in the pool which can be on a path from
+        *cert* upwards, following all candidates where certificates have been
+        cross-signed.
+        """
+        result: List[X509] = []
+        seen = {id(cert)}
+        pending = [cert]
+        while pending:
+            x509 = pending.pop()._x509
+            if (
+                _lib.X509_NAME_cmp(
+                    _lib.X509_get_subject_name(x509),
+                    _lib.X509_get_issuer_name(x509),
+                )
+                == 0
+            ):
+                continue
+            for issuer in self._find_issuers(x509):
+                if id(issuer) not in seen:
+                    seen.add(id(issuer))
+                    result.append(issuer)
+                    pending.append(issuer)
+        return result
+
+
+def _get_name_der(name: Any) -> bytes:
+    """
+    Return the DER encoding of an X509_NAME*.
+    """
+    result_buffer = _ffi.new("unsigned char**")
+    encode_result = _lib.i2d_X509_NAME(name, result_buffer)
+    _openssl_assert(encode_result >= 0)
+
+    string_result = _ffi.buffer(result_buffer[0], encode_result)[:]
+    _lib.OPENSSL_free(result_buffer[0])
+    return string_result
+
+
+def _get_subject_der(data: Any, offset: int) -> bytes:
+    """
+    Return the DER encoding of the subject of the DER certificate at *offset*
+    in *data* without decoding the rest of it.
+    """
+    # Certificate ::= SEQUENCE { tbsCertificate SEQUENCE { version [0]
+    #     OPTIONAL, serialNumber, signature, issuer, validity, subject, ...
+    _, start, _ = _der_value(data, offset)
+    _, position, _ = _der_value(data, start)
+    tag, _, end = _der_value(data, position)
+    if tag == 0xA0:
+        position = end
+    for _ in range(4):
+        position = _der_value(data, position)[2]
+    end = _der_value(data, position)[2]
+    return bytes(data[position:end])
+
+
+class X509LazyStore(X509Store):
+    """
+    An X.509 store which decodes its trusted certificates only when a
+    verification needs them.
+
+    Adding a large number of trusted certificates with
+    :meth:`X509Store.add_cert` decodes all of them up front, and a hashed
+    *capath* directory costs a file open for every lookup.  This store
+    instead keeps batches of DER certificates, as written by
+    :func:`dump_certificate_batch`, indexed by subject name, and decodes a
+    certificate the first time it is looked up as an issuer.
+
+    Issuers are only looked up among the certificates added with
+    :meth:`add_cert` and :meth:`add_cert_batch`, so
+    :meth:`X509Store.load_locations` is not supported.  Certificates are
+    matched by the exact encoding of their subject name, and among those that
+    issued the certificate being verified, one valid at the verification time
+    is preferred.
+
+    .. versionadded:: 24.2.0
+    """
+
+    def __init__(self) -> None:
+        super().__init__()
+        self._index: Dict[bytes, List[Any]] = {}
+        self._buffers: List[Any] = []
+        self._time: Optional[int] = None
+        self._get_issuer_callback = _ffi.callback(
+            "int (*)(X509 **, X509_STORE_CTX *, X509 *)", self._get_issuer
+        )
+        _lib.X509_STORE_set_get_issuer(self._store, self._get_issuer_callback)
+
+    def add_cert(self, cert: X509) -> None:
+        super().add_cert(cert)
+        subject = _get_name_der(_lib.X509_get_subject_name(cert._x509))
+        self._index.setdefault(subject, []).append(cert)
+
+    def add_cert_batch(self, batch: Any) -> None:
+        """
+        Add the trusted certificates in a buffer created by
+        :func:`dump_certificate_batch`.
+
+        Only the subject name of each certificate is read now.  The buffer is
+        kept and not copied, so it may be an :class:`mmap.mmap` of a file.
+
+        :param batch: An object supporting the buffer protocol.
+        :raises ValueError: If the batch is truncated or a certificate in it
+            is malformed.
+        :return: ``None``
+        """
+        view = memoryview(batch).cast("B")
+        if len(view) < 4:
+            raise ValueError("truncated certificate batch")
+
+        data = _ffi.from_buffer(view)
+        count = int.from_bytes(view[:4], "big")
+        offset = 4
+        entries = []
+        for _ in range(count):
+            if offset + 4 > len(view):
+                raise ValueError("truncated certificate batch")
+            length = int.from_bytes(view[offset : offset + 4], "big")
+            offset += 4
+            if offset + length > len(view):
+                raise ValueError("truncated certificate batch")
+            record = view[offset : offset + length]
+            try:
+                subject = _get_subject_der(record, 0)
+            except (IndexError, ValueError):
+                raise ValueError("malformed certificate in batch")
+            entries.append((subject, (data + offset, length)))
+            offset += length
+
+        self._modify()
+        self._buffers.append(data)
+        for subject, entry in entries:
+            self._index.setdefault(subject, []).append(entry)
+
+    def _new_replica(self) -> Any:
+        # Replicas look issuers up in the same index.
+        store = super()._new_replica()
+        _lib.X509_STORE_set_get_issuer(store, self._get_issuer_callback)
+        return store
+
+    def _candidates(self, subject: bytes) -> List[X509]:
+        """
+        Return the certificates with the given subject, decoding the ones that
+        have not been yet.
+        """
+        entries = self._index.get(subject)
+        if entries is None:
+            return []
+
+        result = []
+        for i, entry in enumerate(entries):
+            if not isinstance(entry, X509):
+                pointer, length = entry
+                bio = _lib.BIO_new_mem_buf(pointer, length)
+                _openssl_assert(bio != _ffi.NULL)
+                bio = _ffi.gc(bio, _lib.BIO_free)
+                x509 = _lib.d2i_X509_bio(bio, _ffi.NULL)
+                if x509 == _ffi.NULL:
+                    _lib.ERR_clear_error()
+                    continue
+                entry = entries[i] = X509._from_raw_x509_ptr(x509)
+            result.append(entry)
+        return result
+
+    def set_time(self, vfy_time: datetime.datetime) -> None:
+        super().set_time(vfy_time)
+        self._time = calendar.timegm(vfy_time.timetuple())
+
+    def _get_issuer(self, issuer: Any, store_ctx: Any, x509: Any) -> int:
+        from cryptography.exceptions import InvalidSignature
+
+        name = _get_name_der(_lib.X509_get_issuer_name(x509))
+        key_id = _get_key_identifier(x509, _NID_AUTHORITY_KEY_IDENTIFIER)
+        subject = None
+        issuers = []
+        for candidate in self._candidates(name):
+            if key_id is not None:
+                subject_key_id = _get_key_identifier(
+                    candidate._x509, _NID_SUBJECT_KEY_IDENTIFIER
+                )
+                if subject_key_id is not None and subject_key_id != key_id:
+                    continue
+            # X509_check_issued is not bound, so check that the candidate
+            # signed the certificate instead.
+            if subject is None:
+                _openssl_assert(_lib.X509_up_ref(x509) == 1)
+                subject = X509._from_raw_x509_ptr(x509).to_cryptography()
+            try:
+                subject.verify_directly_issued_by(candidate.to_cryptography())
+            except (InvalidSignature, TypeError, ValueError):
+                continue
+            issuers.append(candidate)
+        if not issuers:
+            return 0
+
+        # Like OpenSSL, prefer an issuer that is valid at the verification
+        # time, and otherwise let verification report the first one.
+        now = int(time.time()) if self._time is None else self._time
+        for candidate in issuers:
+            not_before = candidate.get_notBefore_timestamp()
+            not_after = candidate.get_notAfter_timestamp()
+            if (not_before is None or not_before <= now) and (
+                not_after is None or now <= not_after
+            ):
+                break
+        else:
+            candidate = issuers[0]
+        _openssl_assert(_lib.X509_up_ref(candidate._x509) == 1)
+        issuer[0] = candidate._x509
+        return 1
+
+    def load_locations(
+        self, cafile: StrOrBytesPath, capath: Optional[StrOrBytesPath] = None
+    ) -> None:
+        raise NotImplementedError("X509LazyStore does not load locations")
 
 
 class X509StoreContextError(Exception):
@@ -1882,18 +2545,25 @@ class X509StoreContext:
         purposes of any verifications.
     :param X509 certificate: The certificate to be verified.
     :param chain: List of untrusted certificates that may be used for building
-        the certificate chain. May be ``None``.
-    :type chain: :class:`list` of :class:`X509`
+        the certificate chain, or an :class:`X509IntermediatePool` to pick
+        them from. May be ``None``.
+    :type chain: :class:`list` of :class:`X509` or
+        :class:`X509IntermediatePool`
+
+    .. versionchanged:: 24.2.0
+        *chain* may be an :class:`X509IntermediatePool`.
     """
 
     def __init__(
         self,
         store: X509Store,
         certificate: X509,
-        chain: Optional[Sequence[X509]] = None,
+        chain: Union[Sequence[X509], X509IntermediatePool, None] = None,
     ) -> None:
         self._store = store
         self._cert = certificate
+        if isinstance(chain, X509IntermediatePool):
+            chain = chain._find_path(certificate)
         self._chain = self._build_certificate_stack(chain)
 
     @staticmethod
@@ -1965,12 +2635,16 @@ class X509StoreContext:
         _openssl_assert(store_ctx != _ffi.NULL)
         store_ctx = _ffi.gc(store_ctx, _lib.X509_STORE_CTX_free)
 
-        ret = _lib.X509_STORE_CTX_init(
-            store_ctx, self._store._store, self._cert._x509, self._chain
-        )
-        _openssl_assert(ret == 1)
+        store = self._store._acquire_store()
+        try:
+            ret = _lib.X509_STORE_CTX_init(
+                store_ctx, store, self._cert._x509, self._chain
+            )
+            _openssl_assert(ret == 1)
 
-        ret = _lib.X509_verify_cert(store_ctx)
+            ret = _lib.X509_verify_cert(store_ctx)
+        finally:
+            self._store._release_store(store)
         if ret <= 0:
             raise self._exception_from_context(store_ctx)
 
@@ -2085,6 +2759,290 @@ def dump_certificate(type: int, cert: X509) -> bytes:
     return _bio_to_string(bio)
 
 
+def dump_certificate_batch(certificates: Iterable[X509]) -> bytes:
+    """
+    Dump several certificates into a single buffer suitable for sharing
+    between processes, for example through
+    :py:class:`multiprocessing.shared_memory.SharedMemory`.
+
+    The buffer holds a 4-byte big-endian certificate count followed by each
+    certificate as a 4-byte big-endian length and its DER encoding.
+
+    :param certificates: The certificates to dump.
+    :type certificates: An iterable of :py:class:`X509`
+    :return: The batch buffer.
+    :rtype: bytes
+
+    .. versionadded:: 24.2.0
+    """
+    ders = [dump_certificate(FILETYPE_ASN1, cert) for cert in certificates]
+    parts = [len(ders).to_bytes(4, "big")]
+    for der in ders:
+        parts.append(len(der).to_bytes(4, "big"))
+        parts.append(der)
+    return b"".join(parts)
+
+
+def load_certificate_batch(buffer: Any) -> List[X509]:
+    """
+    Load the certificates in a buffer created by
+    :py:func:`dump_certificate_batch`.
+
+    Certificates are decoded straight out of *buffer* without copying it, so
+    it may be the ``buf`` of a shared memory block.  Bytes after the last
+    certificate (such as page padding) are ignored.
+
+    :param buffer: An object supporting the buffer protocol.
+    :return: The certificates, in the order they were dumped.
+    :rtype: list of :py:class:`X509`
+
+    .. versionadded:: 24.2.0
+    """
+    view = memoryview(buffer).cast("B")
+    if len(view) < 4:
+        raise ValueError("truncated certificate batch")
+
+    data = _ffi.from_buffer(view)
+    count = int.from_bytes(view[:4], "big")
+    offset = 4
+    result = []
+    for _ in range(count):
+        if offset + 4 > len(view):
+            raise ValueError("truncated certificate batch")
+        length = int.from_bytes(view[offset : offset + 4], "big")
+        offset += 4
+        if offset + length > len(view):
+            raise ValueError("truncated certificate batch")
+
+        bio = _lib.BIO_new_mem_buf(data + offset, length)
+        _openssl_assert(bio != _ffi.NULL)
+        bio = _ffi.gc(bio, _lib.BIO_free)
+        x509 = _lib.d2i_X509_bio(bio, _ffi.NULL)
+        if x509 == _ffi.NULL:
+            _raise_current_error()
+        result.append(X509._from_raw_x509_ptr(x509))
+        offset += length
+
+    return result
+
+
+def load_certificates(
+    type: int,
+    buffers: Sequence[bytes],
+    max_workers: Optional[int] = None,
+) -> List[X509]:
+    """
+    Load many certificates using several threads.
+
+    This is equivalent to calling :py:func:`load_certificate` on each buffer,
+    but spreads the work over a thread pool.
+
+    :param type: The file type (one of FILETYPE_PEM, FILETYPE_ASN1)
+    :param buffers: The buffers the certificates are stored in.
+    :param max_workers: The maximum number of threads to use, or ``None`` to
+        use one per CPU.
+    :return: The certificates, in the same order as *buffers*.
+    :raises OpenSSL.crypto.Error: If a buffer cannot be loaded; the error is
+        the one for the first such buffer.
+
+    .. versionadded:: 24.2.0
+    """
+    if type not in (FILETYPE_PEM, FILETYPE_ASN1):
+        raise ValueError("type argument must be FILETYPE_PEM or FILETYPE_ASN1")
+
+    return _map_in_threads(
+        partial(load_certificate, type), list(buffers), max_workers
+    )
+
+
+def digest_certificates(
+    certificates: Sequence[X509],
+    digest_name: str,
+    max_workers: Optional[int] = None,
+) -> List[bytes]:
+    """
+    Compute the digest of many certificates using several threads.
+
+    :param certificates: The certificates to digest.
+    :type certificates: A sequence of :py:class:`X509`
+    :param digest_name: The name of the digest algorithm to use.
+    :param max_workers: The maximum number of threads to use, or ``None`` to
+        use one per CPU.
+    :return: The digests in the format returned by :py:meth:`X509.digest`, in
+        the same order as *certificates*.
+
+    .. versionadded:: 24.2.0
+    """
+    if _lib.EVP_get_digestbyname(_byte_string(digest_name)) == _ffi.NULL:
+        raise ValueError("No such digest method")
+
+    return _map_in_threads(
+        lambda cert: cert.digest(digest_name), list(certificates), max_workers
+    )
+
+
+def verify_certificates(
+    store: X509Store,
+    certificates: Sequence[X509],
+    chain: Union[Sequence[X509], X509IntermediatePool, None] = None,
+    max_workers: Optional[int] = None,
+) -> List[Optional[X509StoreContextError]]:
+    """
+    Verify many certificates against the same store using several threads.
+
+    :param X509Store store: The certificates which will be trusted for the
+        purposes of the verifications.
+    :param certificates: The certificates to verify.
+    :type certificates: A sequence of :py:class:`X509`
+    :param chain: List of untrusted certificates that may be used for building
+        the certificate chains, or an :class:`X509IntermediatePool` to pick
+        them from. May be ``None``.
+    :param max_workers: The maximum number of threads to use, or ``None`` to
+        use one per CPU.
+    :return: For each certificate, in order, ``None`` if it verified or the
+        :py:class:`X509StoreContextError` describing why it did not.
+
+    .. versionadded:: 24.2.0
+    """
+
+    def verify(cert: X509) -> Optional[X509StoreContextError]:
+        try:
+            X509StoreContext(store, cert, chain).verify_certificate()
+        except X509StoreContextError as e:
+            return e
+        return None
+
+    return _map_in_threads(verify, list(certificates), max_workers)
+
+
+# The binding exposes neither ERR_GET_LIB nor these library and reason
+# codes, which are the same in OpenSSL 1.1 and 3.
+_ERR_LIB_PEM = 9
+_PEM_R_NO_START_LINE = 108
+
+
+def _is_pem_no_start_line(code: int) -> bool:
+    """
+    Whether the packed OpenSSL error *code* is the one ``PEM_read_bio_*``
+    functions report when there is no PEM block left to read.
+    """
+    if _lib.OPENSSL_VERSION_NUMBER >= 0x30000000:
+        # OpenSSL 3 sets the top bit for system errors and keeps the library
+        # in the next eight bits.
+        if code & 0x80000000:
+            return False
+        library = (code >> 23) & 0xFF
+    else:
+        library = (code >> 24) & 0xFF
+    return (
+        library == _ERR_LIB_PEM
+        and _lib.ERR_GET_REASON(code) == _PEM_R_NO_START_LINE
+    )
+
+
+_T = TypeVar("_T")
+
+
+def _read_pem_objects(
+    data: bytes,
+    read: Callable[..., Any],
+    wrap: Callable[[Any], _T],
+    exception_type: Type[Exception] = Error,
+) -> List[_T]:
+    """
+    Read every PEM block of one kind from *data* with the ``PEM_read_bio_*``
+    function *read*, skipping blocks of other kinds.  *wrap* takes ownership
+    of each object read.
+
+    Running out of blocks ends the list; any other error, such as a corrupt
+    or truncated block, is raised as *exception_type*.
+    """
+    bio = _new_mem_buf(data)
+    objects = []
+    while True:
+        obj = read(bio, _ffi.NULL, _ffi.NULL, _ffi.NULL)
+        if obj == _ffi.NULL:
+            break
+        objects.append(wrap(obj))
+    if not _is_pem_no_start_line(_lib.ERR_peek_error()):
+        _exception_from_error_queue(exception_type)
+    _lib.ERR_clear_error()
+    return objects
+
+
+def _load_certificate_file(path: StrOrBytesPath) -> List[X509]:
+    """
+    Load every certificate in a PEM file, or the single certificate in a DER
+    file.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    if b"-----BEGIN" not in data:
+        return [load_certificate(FILETYPE_ASN1, data)]
+
+    result = _read_pem_objects(
+        data, _lib.PEM_read_bio_X509, X509._from_raw_x509_ptr
+    )
+    if not result:
+        raise Error([("PEM routines", "", "no certificates found")])
+    return result
+
+
+def find_expiring_certificates(
+    certificates: Union[Sequence[X509], StrOrBytesPath],
+    within: int,
+    now: Optional[int] = None,
+    max_workers: Optional[int] = None,
+) -> List[X509]:
+    """
+    Find the certificates that stop being valid within a window.
+
+    :param certificates: The certificates to scan, or the path of a directory
+        whose files contain them.  Each file holds either one DER certificate
+        or any number of PEM certificates.
+    :type certificates: A sequence of :py:class:`X509`, or a path
+    :param int within: The length of the window, in seconds.
+    :param now: The start of the window, in seconds since the epoch, or
+        ``None`` to use the current time.
+    :param max_workers: The maximum number of threads to use, or ``None`` to
+        use one per CPU.
+    :return: The certificates whose not-after time is at or before the end of
+        the window, including those that have already expired, in input
+        order.  Files in a directory are scanned in name order.
+    :raises OpenSSL.crypto.Error: If a file in the directory cannot be loaded.
+
+    .. versionadded:: 24.2.0
+    """
+    if now is None:
+        now = int(time.time())
+    deadline = now + within
+
+    def expiring(cert: X509) -> bool:
+        not_after = cert.get_notAfter_timestamp()
+        return not_after is not None and not_after <= deadline
+
+    if isinstance(certificates, (str, bytes, PathLike)):
+        directory = os.fsdecode(typing.cast(StrOrBytesPath, certificates))
+        paths = sorted(
+            entry.path for entry in os.scandir(directory) if entry.is_file()
+        )
+
+        def scan(path: str) -> List[X509]:
+            return [
+                cert for cert in _load_certificate_file(path) if expiring(cert)
+            ]
+
+        return [
+            cert
+            for found in _map_in_threads(scan, paths, max_workers)
+            for cert in found
+        ]
+
+    certs = list(certificates)
+    flags = _map_in_threads(expiring, certs, max_workers)
+    return [cert for cert, flag in zip(certs, flags) if flag]
+
+
 def dump_publickey(type: int, pkey: PKey) -> bytes:
     """
     Dump a public key to a buffer.
@@ -2378,7 +3336,15 @@ class CRL:
         crl = _lib.X509_CRL_new()
         self._crl = _ffi.gc(crl, _lib.X509_CRL_free)
 
-    def to_cryptography(self) -> x509.CertificateRevocationList:
+    def __reduce__(self) -> Tuple[Any, Tuple[bytes]]:
+        """
+        Pickle as DER.
+        """
+        # Reference a private loader: the public load_crl is deprecated and
+        # would warn on every unpickle.
+        return (_unpickle_crl, (_dump_crl_internal(FILETYPE_ASN1, self),))
+
+    def to_cryptography(self) -> "x509.CertificateRevocationList":
         """
         Export as a ``cryptography`` CRL.
 
@@ -2393,7 +3359,7 @@ class CRL:
 
     @classmethod
     def from_cryptography(
-        cls, crypto_crl: x509.CertificateRevocationList
+        cls, crypto_crl: "x509.CertificateRevocationList"
     ) -> "_CRLInternal":
         """
         Construct based on a ``cryptography`` *crypto_crl*.
@@ -2405,6 +3371,8 @@ class CRL:
 
         .. versionadded:: 17.1.0
         """
+        from cryptography import x509
+
         if not isinstance(crypto_crl, x509.CertificateRevocationList):
             raise TypeError("Must be a certificate revocation list")
 
@@ -2452,6 +3420,115 @@ class CRL:
         add_result = _lib.X509_CRL_add0_revoked(self._crl, copy)
         _openssl_assert(add_result != 0)
 
+    def add_revocations(
+        self,
+        revocations: Iterable[
+            Tuple[int, Union[int, datetime.datetime], Optional[int]]
+        ],
+    ) -> int:
+        """
+        Add many revocations to the CRL.
+
+        This is equivalent to calling :meth:`add_revoked` with a
+        :class:`Revoked` for each revocation, but the entries are built
+        straight from integers instead of hexadecimal and time strings and
+        reason names, and are not copied.
+
+        :param revocations: ``(serial, date, reason)`` tuples giving the
+            positive serial number of each revoked certificate, when it
+            was revoked as a POSIX timestamp or :class:`datetime.datetime`,
+            and the RFC 5280 ``CRLReason`` code or ``None`` for no reason.
+        :raises ValueError: If a revocation is invalid, in which case none
+            are added.
+        :return: The number of revocations added.
+
+        .. versionadded:: 24.2.0
+        """
+        # Revocations usually come in runs with the same date, so the
+        # previous date is remembered instead of every date.
+        last_timestamp: Optional[int] = None
+        revocation_date = None
+        reasons: Dict[int, Any] = {}
+        # Every serial number goes through these, which are reused: an
+        # ASN1_INTEGER_set takes a C long, which is 32 bits on Windows.
+        bignum = _lib.BN_new()
+        _openssl_assert(bignum != _ffi.NULL)
+        bignum = _ffi.gc(bignum, _lib.BN_free)
+        asn1_serial = _lib.BN_to_ASN1_INTEGER(bignum, _ffi.NULL)
+        _openssl_assert(asn1_serial != _ffi.NULL)
+        asn1_serial = _ffi.gc(asn1_serial, _lib.ASN1_INTEGER_free)
+
+        # Build every entry before adding any, so that the CRL is left
+        # unchanged if one of them is invalid.
+        entries = []
+        added = 0
+        try:
+            for serial, date, reason in revocations:
+                if serial <= 0:
+                    raise ValueError(
+                        f"Serial numbers must be positive: {serial}"
+                    )
+                if reason is not None and reason not in _CRL_REASON_EXTENSIONS:
+                    raise ValueError(f"Invalid CRL reason: {reason!r}")
+
+                timestamp = _timestamp(date)
+                if timestamp != last_timestamp:
+                    revocation_date = _new_asn1_time(_time_string(timestamp))
+                    last_timestamp = timestamp
+                reason_code = None
+                if reason is not None:
+                    reason_code = reasons.get(reason)
+                    if reason_code is None:
+                        reason_code = _lib.ASN1_ENUMERATED_new()
+                        _openssl_assert(reason_code != _ffi.NULL)
+                        reason_code = reasons[reason] = _ffi.gc(
+                            reason_code, _lib.ASN1_ENUMERATED_free
+                        )
+                        _openssl_assert(
+                            _lib.ASN1_ENUMERATED_set(reason_code, reason) == 1
+                        )
+
+                data = serial.to_bytes((serial.bit_length() + 7) // 8, "big")
+                _openssl_assert(
+                    _lib.BN_bin2bn(data, len(data), bignum) != _ffi.NULL
+                )
+                _openssl_assert(
+                    _lib.BN_to_ASN1_INTEGER(bignum, asn1_serial) != _ffi.NULL
+                )
+
+                revoked = _lib.X509_REVOKED_new()
+                _openssl_assert(revoked != _ffi.NULL)
+                entries.append(revoked)
+                _openssl_assert(
+                    _lib.X509_REVOKED_set_serialNumber(revoked, asn1_serial)
+                    == 1
+                )
+                _openssl_assert(
+                    _lib.X509_REVOKED_set_revocationDate(
+                        revoked, revocation_date
+                    )
+                    == 1
+                )
+                if reason_code is not None:
+                    _openssl_assert(
+                        _lib.X509_REVOKED_add1_ext_i2d(
+                            revoked, _lib.NID_crl_reason, reason_code, 0, 0
+                        )
+                        == 1
+                    )
+
+            for revoked in entries:
+                _openssl_assert(
+                    _lib.X509_CRL_add0_revoked(self._crl, revoked) != 0
+                )
+                added += 1
+        except BaseException:
+            # The CRL owns the entries added before a failure.
+            for revoked in entries[added:]:
+                _lib.X509_REVOKED_free(revoked)
+            raise
+        return len(entries)
+
     def get_issuer(self) -> X509Name:
         """
         Get the CRL's issuer.
@@ -2767,6 +3844,84 @@ def load_privatekey(
     return pkey
 
 
+def _load_privatekey_with_passphrase(
+    type: int, item: Tuple[bytes, Optional[bytes]]
+) -> PKey:
+    buffer, passphrase = item
+    bio = _new_mem_buf(buffer)
+    # Passing the passphrase as the user data of OpenSSL's default password
+    # callback keeps Python out of the key derivation, so the GIL stays
+    # released for the whole decryption.  An empty passphrase stops OpenSSL
+    # from prompting on the terminal for an encrypted key.
+    password = _ffi.new("char[]", passphrase or b"")
+    if type == FILETYPE_PEM:
+        evp_pkey = _lib.PEM_read_bio_PrivateKey(
+            bio, _ffi.NULL, _ffi.NULL, password
+        )
+    elif passphrase is None:
+        evp_pkey = _lib.d2i_PrivateKey_bio(bio, _ffi.NULL)
+    else:
+        evp_pkey = _lib.d2i_PKCS8PrivateKey_bio(
+            bio, _ffi.NULL, _ffi.NULL, password
+        )
+        if evp_pkey == _ffi.NULL:
+            # Not an encrypted PKCS #8 key, or the wrong passphrase: try it
+            # as an unencrypted key, and report both failures if that fails
+            # too.
+            evp_pkey = _lib.d2i_PrivateKey_bio(_new_mem_buf(buffer), _ffi.NULL)
+            if evp_pkey != _ffi.NULL:
+                _lib.ERR_clear_error()
+
+    if evp_pkey == _ffi.NULL:
+        _raise_current_error()
+
+    pkey = PKey.__new__(PKey)
+    pkey._pkey = _ffi.gc(evp_pkey, _lib.EVP_PKEY_free)
+    return pkey
+
+
+def load_privatekeys(
+    type: int,
+    keys: Sequence[Tuple[bytes, Optional[bytes]]],
+    max_workers: Optional[int] = None,
+) -> List[PKey]:
+    """
+    Load many private keys, each with its own passphrase, using several
+    threads.
+
+    Unlike :func:`load_privatekey`, the passphrases are handed to OpenSSL
+    directly rather than through a Python callback, so the key derivation
+    of every encrypted key runs without holding the GIL.
+
+    :param type: The file type (one of FILETYPE_PEM, FILETYPE_ASN1)
+    :param keys: ``(buffer, passphrase)`` pairs.  *passphrase* is the
+        :class:`bytes` the key is encrypted with, or ``None`` if it is not
+        encrypted.  Encrypted DER keys must be in PKCS #8 format, and
+        unencrypted ones are loaded whatever the passphrase.
+    :param max_workers: The maximum number of threads to use, or ``None`` to
+        use one per CPU.
+    :return: The :class:`PKey` objects, in input order.
+    :raises Error: If any buffer is not a private key or its passphrase is
+        wrong.
+
+    .. versionadded:: 24.2.0
+    """
+    if type not in (FILETYPE_PEM, FILETYPE_ASN1):
+        raise ValueError("type argument must be FILETYPE_PEM or FILETYPE_ASN1")
+    keys = list(keys)
+    for _, passphrase in keys:
+        if passphrase is None:
+            continue
+        if not isinstance(passphrase, bytes):
+            raise TypeError("passphrase must be a byte string or None")
+        if b"\0" in passphrase:
+            raise ValueError("passphrase must not contain NUL bytes")
+
+    return _map_in_threads(
+        partial(_load_privatekey_with_passphrase, type), keys, max_workers
+    )
+
+
 def dump_certificate_request(type: int, req: X509Req) -> bytes:
     """
     Dump the certificate request *req* into a buffer string encoded with the
@@ -2823,6 +3978,175 @@ def load_certificate_request(type: int, buffer: bytes) -> X509Req:
     return x509req
 
 
+class CertificateRequestInfo(typing.NamedTuple):
+    """
+    The facts about a certificate signing request needed to issue a
+    certificate for it, as returned by :func:`validate_certificate_requests`.
+
+    .. versionadded:: 24.2.0
+    """
+
+    #: The components of the subject, in the format of
+    #: :meth:`X509Name.get_components`.
+    subject: Tuple[Tuple[bytes, bytes], ...]
+    #: The DNS names of the subjectAltName extension.
+    dns_names: Tuple[str, ...]
+    #: The IP addresses of the subjectAltName extension, as strings.
+    ip_addresses: Tuple[str, ...]
+    #: The email addresses of the subjectAltName extension.
+    email_addresses: Tuple[str, ...]
+    #: The type of the public key: ``"rsa"``, ``"rsa-pss"``, ``"dsa"``,
+    #: ``"ec"``, ``"ed25519"``, ``"ed448"`` or ``"unknown"``.
+    key_type: str
+    #: The size of the public key in bits.
+    key_bits: int
+    #: Whether the request is signed by the key it contains.
+    signature_valid: bool
+
+
+_KEY_TYPE_NAMES = {
+    _lib.EVP_PKEY_RSA: "rsa",
+    _lib.EVP_PKEY_RSA_PSS: "rsa-pss",
+    _lib.EVP_PKEY_DSA: "dsa",
+    _lib.EVP_PKEY_EC: "ec",
+    _lib.EVP_PKEY_ED25519: "ed25519",
+    _lib.EVP_PKEY_ED448: "ed448",
+}
+
+
+def _parse_subject_alt_names(
+    data: bytes,
+) -> Tuple[Tuple[str, ...], Tuple[str, ...], Tuple[str, ...]]:
+    """
+    Return the DNS names, IP addresses and email addresses in the DER
+    encoding of a subjectAltName extension.
+    """
+    import ipaddress
+
+    dns_names = []
+    ip_addresses = []
+    email_addresses = []
+    # GeneralNames ::= SEQUENCE OF GeneralName, where GeneralName is a CHOICE
+    # of context specific tags: [1] rfc822Name, [2] dNSName, [7] iPAddress.
+    tag, position, end = _der_value(data, 0)
+    if tag != 0x30:
+        raise ValueError("malformed subjectAltName")
+    while position < end:
+        tag, start, position = _der_value(data, position)
+        value = data[start:position]
+        if tag == 0x82:
+            dns_names.append(value.decode("ascii"))
+        elif tag == 0x87:
+            ip_addresses.append(str(ipaddress.ip_address(value)))
+        elif tag == 0x81:
+            email_addresses.append(value.decode("ascii"))
+    return tuple(dns_names), tuple(ip_addresses), tuple(email_addresses)
+
+
+def _validate_certificate_request(
+    type: int, buffer: bytes
+) -> Union[CertificateRequestInfo, Exception]:
+    try:
+        bio = _new_mem_buf(buffer)
+        if type == FILETYPE_PEM:
+            req = _lib.PEM_read_bio_X509_REQ(
+                bio, _ffi.NULL, _ffi.NULL, _ffi.NULL
+            )
+        else:
+            req = _lib.d2i_X509_REQ_bio(bio, _ffi.NULL)
+        if req == _ffi.NULL:
+            _raise_current_error()
+        req = _ffi.gc(req, _lib.X509_REQ_free)
+
+        pkey = _lib.X509_REQ_get_pubkey(req)
+        if pkey == _ffi.NULL:
+            _raise_current_error()
+        pkey = _ffi.gc(pkey, _lib.EVP_PKEY_free)
+        signature_valid = _lib.X509_REQ_verify(req, pkey) == 1
+        if not signature_valid:
+            _lib.ERR_clear_error()
+
+        subject = X509Name.__new__(X509Name)
+        subject._name = _lib.X509_REQ_get_subject_name(req)
+        components = tuple(subject.get_components())
+
+        subject_alt_names: Tuple[Tuple[str, ...], ...] = ((), (), ())
+        extensions = _lib.X509_REQ_get_extensions(req)
+        if extensions != _ffi.NULL:
+            extensions = _ffi.gc(
+                extensions,
+                lambda x: _lib.sk_X509_EXTENSION_pop_free(
+                    x,
+                    _ffi.addressof(_lib._original_lib, "X509_EXTENSION_free"),
+                ),
+            )
+            for i in range(_lib.sk_X509_EXTENSION_num(extensions)):
+                extension = _lib.sk_X509_EXTENSION_value(extensions, i)
+                nid = _lib.OBJ_obj2nid(
+                    _lib.X509_EXTENSION_get_object(extension)
+                )
+                if nid != _lib.NID_subject_alt_name:
+                    continue
+                octets = _ffi.cast(
+                    "ASN1_STRING*", _lib.X509_EXTENSION_get_data(extension)
+                )
+                subject_alt_names = _parse_subject_alt_names(
+                    _ffi.buffer(
+                        _lib.ASN1_STRING_get0_data(octets),
+                        _lib.ASN1_STRING_length(octets),
+                    )[:]
+                )
+
+        dns_names, ip_addresses, email_addresses = subject_alt_names
+        return CertificateRequestInfo(
+            subject=components,
+            dns_names=dns_names,
+            ip_addresses=ip_addresses,
+            email_addresses=email_addresses,
+            key_type=_KEY_TYPE_NAMES.get(_lib.EVP_PKEY_id(pkey), "unknown"),
+            key_bits=_lib.EVP_PKEY_bits(pkey),
+            signature_valid=signature_valid,
+        )
+    except (Error, ValueError) as e:
+        return e
+
+
+def validate_certificate_requests(
+    type: int,
+    buffers: Sequence[bytes],
+    max_workers: Optional[int] = None,
+) -> List[Union[CertificateRequestInfo, Exception]]:
+    """
+    Parse many certificate signing requests, check their signatures and
+    extract what is needed to issue certificates for them, using several
+    threads.
+
+    This replaces calling :func:`load_certificate_request`,
+    :meth:`X509Req.verify`, :meth:`X509Req.get_subject` and
+    :meth:`X509Req.get_extensions` for each request: nothing is copied and
+    the subject alternative names are read straight from their encoding.
+
+    :param type: The file type (one of FILETYPE_PEM, FILETYPE_ASN1)
+    :param buffers: The buffers the requests are stored in.
+    :param max_workers: The maximum number of threads to use, or ``None`` to
+        use one per CPU.
+    :return: For each buffer, in order, a :class:`CertificateRequestInfo`,
+        or the exception describing why it could not be read:
+        :class:`OpenSSL.crypto.Error` if it is not a request, or
+        :class:`ValueError` if its subjectAltName is malformed.
+
+    .. versionadded:: 24.2.0
+    """
+    if type not in (FILETYPE_PEM, FILETYPE_ASN1):
+        raise ValueError("type argument must be FILETYPE_PEM or FILETYPE_ASN1")
+
+    return _map_in_threads(
+        partial(_validate_certificate_request, type),
+        list(buffers),
+        max_workers,
+    )
+
+
 def sign(pkey: PKey, data: Union[str, bytes], digest: str) -> bytes:
     """
     Sign a data string using the given key and message digest.
@@ -2997,3 +4321,268 @@ utils.deprecated(
     DeprecationWarning,
     name="load_crl",
 )
+
+
+def _der_header(tag: int, length: int) -> bytes:
+    if length < 0x80:
+        return bytes((tag, length))
+    size = (length.bit_length() + 7) // 8
+    return bytes((tag, 0x80 | size)) + length.to_bytes(size, "big")
+
+
+def _der(tag: int, content: bytes) -> bytes:
+    return _der_header(tag, len(content)) + content
+
+
+def _der_integer(value: int) -> bytes:
+    """
+    Encode a non-negative INTEGER.  Negative values would not be encoded in
+    the minimal number of bytes DER requires.
+    """
+    return _der(
+        0x02, value.to_bytes(value.bit_length() // 8 + 1, "big", signed=True)
+    )
+
+
+def _time_string(when: int) -> bytes:
+    """
+    Format a POSIX timestamp as the Time of RFC 5280: UTCTime up to 2049 and
+    GeneralizedTime after.
+    """
+    fields = time.gmtime(when)
+    if 1950 <= fields.tm_year < 2050:
+        return time.strftime("%y%m%d%H%M%SZ", fields).encode()
+    return time.strftime("%Y%m%d%H%M%SZ", fields).encode()
+
+
+def _der_time(when: int) -> bytes:
+    string = _time_string(when)
+    # UTCTime strings are two digits shorter than GeneralizedTime ones.
+    return _der(0x17 if len(string) == 13 else 0x18, string)
+
+
+def _timestamp(when: Union[int, datetime.datetime]) -> int:
+    if isinstance(when, datetime.datetime):
+        if when.tzinfo is None:
+            return calendar.timegm(when.timetuple())
+        return int(when.timestamp())
+    return int(when)
+
+
+def _der_extension(oid: bytes, value: bytes, critical: bool = False) -> bytes:
+    return _der(
+        0x30, oid + (b"\x01\x01\xff" if critical else b"") + _der(0x04, value)
+    )
+
+
+# DER encoded object identifiers for write_crl.
+_OID_CRL_REASON = b"\x06\x03\x55\x1d\x15"
+_OID_CRL_NUMBER = b"\x06\x03\x55\x1d\x14"
+_OID_DELTA_CRL_INDICATOR = b"\x06\x03\x55\x1d\x1b"
+_OID_AUTHORITY_KEY_IDENTIFIER = b"\x06\x03\x55\x1d\x23"
+_RSA_SIGNATURE_OIDS = {
+    "sha256": b"\x06\x09\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0b",
+    "sha384": b"\x06\x09\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0c",
+    "sha512": b"\x06\x09\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0d",
+}
+_ECDSA_SIGNATURE_OIDS = {
+    "sha256": b"\x06\x08\x2a\x86\x48\xce\x3d\x04\x03\x02",
+    "sha384": b"\x06\x08\x2a\x86\x48\xce\x3d\x04\x03\x03",
+    "sha512": b"\x06\x08\x2a\x86\x48\xce\x3d\x04\x03\x04",
+}
+
+# The crlEntryExtensions of an entry with each CRLReason.  7 is not used.
+_CRL_REASON_EXTENSIONS = {
+    code: _der(
+        0x30, _der_extension(_OID_CRL_REASON, _der(0x0A, bytes((code,))))
+    )
+    for code in [0, 1, 2, 3, 4, 5, 6, 8, 9, 10]
+}
+
+
+def write_crl(
+    out: IO[bytes],
+    cert: X509,
+    key: PKey,
+    revocations: Iterable[
+        Tuple[int, Union[int, datetime.datetime], Optional[int]]
+    ],
+    last_update: Union[int, datetime.datetime],
+    next_update: Union[int, datetime.datetime],
+    digest: str = "sha256",
+    crl_number: Optional[int] = None,
+    delta_crl_base: Optional[int] = None,
+) -> int:
+    """
+    Write a signed DER certificate revocation list, encoding the revoked
+    certificates as they are produced.
+
+    Unlike :meth:`CRL.export`, the revocations are never held in memory
+    together: they are encoded one by one into a temporary file, which is
+    then hashed and copied to *out*.  This makes it suitable for CRLs with
+    millions of entries.
+
+    :param out: A binary file object to write the CRL to, such as an open
+        file or :class:`io.BytesIO`.
+    :param X509 cert: The certificate of the CRL issuer.
+    :param PKey key: The RSA or EC private key of the CRL issuer.
+    :param revocations: ``(serial, date, reason)`` tuples giving the serial
+        number of each revoked certificate, when it was revoked, and the
+        RFC 5280 ``CRLReason`` code or ``None`` for no reason.
+    :type revocations: An iterable of tuples of :class:`int`, :class:`int`
+        or :class:`datetime.datetime`, and :class:`int` or ``None``
+    :param last_update: When this CRL is issued.
+    :param next_update: When the next CRL will be issued.
+    :param str digest: The name of the message digest to sign with, one of
+        ``"sha256"``, ``"sha384"`` and ``"sha512"``.
+    :param crl_number: The ``cRLNumber`` extension, if any.
+    :param delta_crl_base: To write a delta CRL, the ``cRLNumber`` of the
+        complete CRL it is based on.  Requires *crl_number*.
+
+    Dates are POSIX timestamps or :class:`datetime.datetime` objects, which
+    are taken to be in UTC if they are naive.
+
+    :return: The number of bytes written.
+
+    .. versionadded:: 24.2.0
+    """
+    import tempfile
+
+    from cryptography.hazmat.primitives import hashes
+    from cryptography.hazmat.primitives.asymmetric import padding
+    from cryptography.hazmat.primitives.asymmetric.utils import Prehashed
+
+    if not isinstance(cert, X509):
+        raise TypeError("cert must be an X509 instance")
+    if not isinstance(key, PKey):
+        raise TypeError("key must be a PKey instance")
+    if delta_crl_base is not None and crl_number is None:
+        raise ValueError("A delta CRL needs a crl_number")
+    for number in [crl_number, delta_crl_base]:
+        if number is not None and number < 0:
+            raise ValueError("CRL numbers must not be negative")
+
+    private_key = key.to_cryptography_key()
+    if isinstance(private_key, rsa.RSAPrivateKey):
+        signature_oids = _RSA_SIGNATURE_OIDS
+        # The parameters of the RSA signature algorithms are NULL.
+        parameters = b"\x05\x00"
+    elif isinstance(private_key, ec.EllipticCurvePrivateKey):
+        signature_oids = _ECDSA_SIGNATURE_OIDS
+        parameters = b""
+    else:
+        raise ValueError("key must be an RSA or EC private key")
+    if digest not in signature_oids:
+        raise ValueError("No such digest method")
+    algorithm = getattr(hashes, digest.upper())()
+    signature_algorithm = _der(0x30, signature_oids[digest] + parameters)
+
+    extensions = []
+    key_id = _get_key_identifier(cert._x509, _NID_SUBJECT_KEY_IDENTIFIER)
+    if key_id is not None:
+        extensions.append(
+            _der_extension(
+                _OID_AUTHORITY_KEY_IDENTIFIER, _der(0x30, _der(0x80, key_id))
+            )
+        )
+    if crl_number is not None:
+        extensions.append(
+            _der_extension(_OID_CRL_NUMBER, _der_integer(crl_number))
+        )
+    if delta_crl_base is not None:
+        extensions.append(
+            _der_extension(
+                _OID_DELTA_CRL_INDICATOR, _der_integer(delta_crl_base), True
+            )
+        )
+    crl_extensions = (
+        _der(0xA0, _der(0x30, b"".join(extensions))) if extensions else b""
+    )
+
+    tbs_prefix = b"".join(
+        [
+            _der_integer(1),
+            signature_algorithm,
+            _get_name_der(_lib.X509_get_subject_name(cert._x509)),
+            _der_time(_timestamp(last_update)),
+            _der_time(_timestamp(next_update)),
+        ]
+    )
+
+    with tempfile.TemporaryFile() as entries:
+        # Only the previous date is remembered, since revocations usually
+        # come in runs with the same date and there may be millions of them.
+        last_date: Union[int, datetime.datetime, None] = None
+        encoded_time = b""
+        chunk = []
+        for serial, date, reason in revocations:
+            if serial <= 0:
+                raise ValueError(f"Serial numbers must be positive: {serial}")
+            if last_date is None or date != last_date:
+                encoded_time = _der_time(_timestamp(date))
+                last_date = date
+            if reason is None:
+                extension = b""
+            elif reason in _CRL_REASON_EXTENSIONS:
+                extension = _CRL_REASON_EXTENSIONS[reason]
+            else:
+                raise ValueError(f"Invalid CRL reason: {reason!r}")
+            chunk.append(
+                _der(0x30, _der_integer(serial) + encoded_time + extension)
+            )
+            if len(chunk) == 4096:
+                entries.write(b"".join(chunk))
+                chunk = []
+        entries.write(b"".join(chunk))
+        entries_length = entries.tell()
+
+        revoked_header = (
+            _der_header(0x30, entries_length) if entries_length else b""
+        )
+        tbs_length = (
+            len(tbs_prefix)
+            + len(revoked_header)
+            + entries_length
+            + len(crl_extensions)
+        )
+        tbs_header = _der_header(0x30, tbs_length)
+        # Everything of the TBSCertList before the first entry.
+        tbs_start = tbs_header + tbs_prefix + revoked_header
+
+        def copy(write: Callable[[bytes], Any]) -> None:
+            entries.seek(0)
+            while True:
+                data = entries.read(1 << 20)
+                if not data:
+                    break
+                write(data)
+
+        hasher = hashes.Hash(algorithm)
+        hasher.update(tbs_start)
+        copy(hasher.update)
+        hasher.update(crl_extensions)
+        if isinstance(private_key, rsa.RSAPrivateKey):
+            signature = private_key.sign(
+                hasher.finalize(), padding.PKCS1v15(), Prehashed(algorithm)
+            )
+        else:
+            signature = private_key.sign(
+                hasher.finalize(), ec.ECDSA(Prehashed(algorithm))
+            )
+
+        signature_value = _der(0x03, b"\x00" + signature)
+        length = (
+            len(tbs_header)
+            + tbs_length
+            + len(signature_algorithm)
+            + len(signature_value)
+        )
+        header = _der_header(0x30, length)
+        out.write(header + tbs_start)
+        copy(out.write)
+        out.write(crl_extensions + signature_algorithm + signature_value)
+        return len(header) + length
+
+
+def _unpickle_crl(der: bytes) -> _CRLInternal:
+    return _load_crl_internal(FILETYPE_ASN1, der)
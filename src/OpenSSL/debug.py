@@ -1,5 +1,9 @@
+import argparse
+import json
 import ssl
 import sys
+import time
+import typing
 
 import cffi
 import cryptography
@@ -36,5 +40,550 @@ sys.path: {sys_path}""".format(
 )
 
 
+# OPENSSL_CPU_INFO, the OpenSSL_version() type that describes the CPU
+# capabilities OpenSSL detected.
+_OPENSSL_CPU_INFO = 9
+
+# The capability bits to report for each capability vector, as
+# (word, bit, name).  See the OPENSSL_ia32cap and OPENSSL_armcap man pages.
+_CPU_FLAGS = {
+    "OPENSSL_ia32cap": [
+        (0, 25, "sse"),
+        (0, 26, "sse2"),
+        (0, 33, "pclmulqdq"),
+        (0, 41, "ssse3"),
+        (0, 57, "aes-ni"),
+        (0, 60, "avx"),
+        (1, 3, "bmi1"),
+        (1, 5, "avx2"),
+        (1, 8, "bmi2"),
+        (1, 16, "avx512f"),
+        (1, 19, "adx"),
+        (1, 29, "sha"),
+        (1, 41, "vaes"),
+        (1, 42, "vpclmulqdq"),
+    ],
+    "OPENSSL_armcap": [
+        (0, 0, "neon"),
+        (0, 2, "aes"),
+        (0, 3, "sha1"),
+        (0, 4, "sha256"),
+        (0, 5, "pmull"),
+        (0, 6, "sha512"),
+    ],
+}
+
+_SPEED_CIPHERS = [
+    b"TLS_AES_128_GCM_SHA256",
+    b"TLS_AES_256_GCM_SHA384",
+    b"TLS_CHACHA20_POLY1305_SHA256",
+]
+_SPEED_RECORD_SIZES = [16, 256, 1024, 8192, 16384]
+_SPEED_TRUST_STORE_SIZE = 1000
+_SPEED_THREADS = [1, 2, 4, 8]
+_SPEED_CSR_COUNT = 100
+_SPEED_PRIVATE_KEY_COUNT = 32
+
+
+def _cpu_info() -> typing.Dict[str, typing.Any]:
+    """
+    Return the CPU capabilities the linked OpenSSL detected, as a dict with
+    the raw ``OpenSSL_version(OPENSSL_CPU_INFO)`` string and the names of the
+    capabilities that are enabled, or ``None`` if they are unknown.
+    """
+    raw = OpenSSL.SSL.OpenSSL_version(_OPENSSL_CPU_INFO).decode("ascii")
+    flags: typing.Optional[typing.List[str]] = None
+    if raw.startswith("CPUINFO: "):
+        name, _, value = raw[len("CPUINFO: ") :].split()[0].partition("=")
+        if name in _CPU_FLAGS:
+            words = [int(word, 16) for word in value.split(":")]
+            flags = [
+                flag
+                for word, bit, flag in _CPU_FLAGS[name]
+                if word < len(words) and words[word] >> bit & 1
+            ]
+    return {"raw": raw, "flags": flags}
+
+
+def _speed_ec_key() -> OpenSSL.crypto.PKey:
+    from cryptography.hazmat.primitives.asymmetric import ec
+
+    return OpenSSL.crypto.PKey.from_cryptography_key(
+        ec.generate_private_key(ec.SECP256R1())
+    )
+
+
+def _speed_contexts(
+    key: OpenSSL.crypto.PKey,
+) -> typing.Tuple[OpenSSL.SSL.Context, OpenSSL.SSL.Context]:
+    """
+    Return a TLS 1.3 server context with a self-signed certificate for
+    *key*, and a client context.
+    """
+    cert = _speed_certificate("pyOpenSSL speed test", key)
+
+    server_context = OpenSSL.SSL.Context(OpenSSL.SSL.TLS_METHOD)
+    server_context.set_min_proto_version(OpenSSL.SSL.TLS1_3_VERSION)
+    server_context.use_privatekey(key)
+    server_context.use_certificate(cert)
+    client_context = OpenSSL.SSL.Context(OpenSSL.SSL.TLS_METHOD)
+    return server_context, client_context
+
+
+def _speed_handshake(
+    server_context: OpenSSL.SSL.Context, client_context: OpenSSL.SSL.Context
+) -> typing.Tuple[OpenSSL.SSL.Connection, OpenSSL.SSL.Connection]:
+    """
+    Return a server and client connected over memory BIOs.
+    """
+    server = OpenSSL.SSL.Connection(server_context, None)
+    server.set_accept_state()
+    client = OpenSSL.SSL.Connection(client_context, None)
+    client.set_connect_state()
+
+    pending = [client, server]
+    while pending:
+        for conn, peer in [(client, server), (server, client)]:
+            if conn in pending:
+                try:
+                    conn.do_handshake()
+                    pending.remove(conn)
+                except OpenSSL.SSL.WantReadError:
+                    pass
+            try:
+                peer.bio_write(conn.bio_read(2**16))
+            except OpenSSL.SSL.WantReadError:
+                pass
+    return server, client
+
+
+def _handshakes_per_second(
+    server_context: OpenSSL.SSL.Context,
+    client_context: OpenSSL.SSL.Context,
+    duration: float,
+) -> float:
+    count = 0
+    start = time.perf_counter()
+    while True:
+        _speed_handshake(server_context, client_context)
+        count += 1
+        elapsed = time.perf_counter() - start
+        if elapsed >= duration:
+            return count / elapsed
+
+
+def _bytes_per_second(
+    server_context: OpenSSL.SSL.Context,
+    client_context: OpenSSL.SSL.Context,
+    size: int,
+    duration: float,
+) -> float:
+    """
+    Return how many bytes per second a client can encrypt and a server can
+    decrypt in records of *size* bytes.
+    """
+    server, client = _speed_handshake(server_context, client_context)
+    data = b"\0" * size
+    total = 0
+    start = time.perf_counter()
+    while True:
+        for _ in range(64):
+            client.send(data)
+            server.bio_write(client.bio_read(2**16))
+            total += len(server.recv(size))
+        elapsed = time.perf_counter() - start
+        if elapsed >= duration:
+            return total / elapsed
+
+
+def _speed_certificate(
+    name: str,
+    key: OpenSSL.crypto.PKey,
+    issuer: typing.Optional[OpenSSL.crypto.X509] = None,
+) -> OpenSSL.crypto.X509:
+    """
+    Return a certificate for *key* named *name*, signed by the same key and
+    issued by *issuer*, or self-signed if it is ``None``.
+    """
+    cert = OpenSSL.crypto.X509()
+    cert.get_subject().commonName = name
+    cert.set_issuer(
+        cert.get_subject() if issuer is None else issuer.get_subject()
+    )
+    cert.set_serial_number(1)
+    cert.gmtime_adj_notBefore(0)
+    cert.gmtime_adj_notAfter(3600)
+    cert.set_pubkey(key)
+    cert.sign(key, "sha256")
+    return cert
+
+
+def _verifications_per_second(
+    store: OpenSSL.crypto.X509Store,
+    cert: OpenSSL.crypto.X509,
+    duration: float,
+) -> float:
+    count = 0
+    start = time.perf_counter()
+    while True:
+        OpenSSL.crypto.X509StoreContext(store, cert).verify_certificate()
+        count += 1
+        elapsed = time.perf_counter() - start
+        if elapsed >= duration:
+            return count / elapsed
+
+
+def _trust_store_speed(
+    duration: float,
+) -> typing.List[typing.Dict[str, typing.Any]]:
+    """
+    Compare loading `_SPEED_TRUST_STORE_SIZE` roots into an X509Store with
+    loading them into an X509LazyStore, and how fast each verifies a
+    certificate issued by one of them.
+    """
+    key = _speed_ec_key()
+    roots = [
+        _speed_certificate(f"pyOpenSSL speed test root {i}", key)
+        for i in range(_SPEED_TRUST_STORE_SIZE)
+    ]
+    leaf = _speed_certificate("pyOpenSSL speed test", key, roots[-1])
+    batch = OpenSSL.crypto.dump_certificate_batch(roots)
+
+    results = []
+    for name in ["X509Store", "X509LazyStore"]:
+        start = time.perf_counter()
+        store: OpenSSL.crypto.X509Store
+        if name == "X509Store":
+            store = OpenSSL.crypto.X509Store()
+            for root in OpenSSL.crypto.load_certificate_batch(batch):
+                store.add_cert(root)
+        else:
+            store = OpenSSL.crypto.X509LazyStore()
+            store.add_cert_batch(batch)
+        load_seconds = time.perf_counter() - start
+        # The first verification decodes the root in the lazy store.
+        start = time.perf_counter()
+        OpenSSL.crypto.X509StoreContext(store, leaf).verify_certificate()
+        first_seconds = time.perf_counter() - start
+        results.append(
+            {
+                "store": name,
+                "certificates": len(roots),
+                "load_seconds": load_seconds,
+                "first_verification_seconds": first_seconds,
+                "verifications_per_second": _verifications_per_second(
+                    store, leaf, duration
+                ),
+            }
+        )
+    return results
+
+
+def _verification_scaling(
+    duration: float,
+) -> typing.List[typing.Dict[str, typing.Any]]:
+    """
+    Measure verifications per second with `verify_certificates` at several
+    thread counts, with one store of 100 roots shared by all threads and
+    with a replica of it per thread.
+    """
+    key = _speed_ec_key()
+    roots = [
+        _speed_certificate(f"pyOpenSSL speed test root {i}", key)
+        for i in range(100)
+    ]
+    leaf = _speed_certificate("pyOpenSSL speed test", key, roots[0])
+    leaves = [leaf] * 256
+
+    results = []
+    for replicated in [False, True]:
+        store = OpenSSL.crypto.X509Store()
+        if replicated:
+            store.replicate_per_thread()
+        for root in roots:
+            store.add_cert(root)
+        for threads in _SPEED_THREADS:
+            count = 0
+            start = time.perf_counter()
+            while True:
+                OpenSSL.crypto.verify_certificates(
+                    store, leaves, max_workers=threads
+                )
+                count += len(leaves)
+                elapsed = time.perf_counter() - start
+                if elapsed >= duration:
+                    break
+            results.append(
+                {
+                    "threads": threads,
+                    "replicated": replicated,
+                    "verifications_per_second": count / elapsed,
+                }
+            )
+    return results
+
+
+def _crl_speed(duration: float) -> typing.Dict[str, typing.Any]:
+    """
+    Measure how fast `write_crl` writes a CRL to a file, producing entries
+    for about *duration* seconds.
+    """
+    import tempfile
+
+    key = _speed_ec_key()
+    cert = _speed_certificate("pyOpenSSL speed test root", key)
+    now = int(time.time())
+    start = time.perf_counter()
+    entries = 0
+
+    def revocations() -> typing.Iterator[typing.Tuple[int, int, typing.Any]]:
+        nonlocal entries
+        while entries == 0 or time.perf_counter() - start < duration:
+            for _ in range(4096):
+                entries += 1
+                yield (entries, now, 1 if entries % 2 else None)
+
+    with tempfile.TemporaryFile() as out:
+        written = OpenSSL.crypto.write_crl(
+            out, cert, key, revocations(), now, now + 86400
+        )
+    elapsed = time.perf_counter() - start
+    return {
+        "entries": entries,
+        "bytes": written,
+        "seconds": elapsed,
+        "entries_per_second": entries / elapsed,
+    }
+
+
+def _csr_speed(duration: float) -> typing.List[typing.Dict[str, typing.Any]]:
+    """
+    Compare validating batches of `_SPEED_CSR_COUNT` certificate signing
+    requests one at a time through X509Req with
+    `validate_certificate_requests`.
+    """
+    key = _speed_ec_key()
+    req = OpenSSL.crypto.X509Req()
+    req.get_subject().commonName = "pyOpenSSL speed test"
+    req.add_extensions(
+        [
+            OpenSSL.crypto.X509Extension(
+                b"subjectAltName",
+                False,
+                b"DNS:example.com, DNS:www.example.com, IP:192.0.2.1",
+            )
+        ]
+    )
+    req.set_pubkey(key)
+    req.sign(key, "sha256")
+    buffers = [
+        OpenSSL.crypto.dump_certificate_request(
+            OpenSSL.crypto.FILETYPE_PEM, req
+        )
+    ] * _SPEED_CSR_COUNT
+
+    results = []
+    for method in ["X509Req", "validate_certificate_requests"]:
+        count = 0
+        start = time.perf_counter()
+        while True:
+            if method == "X509Req":
+                for buffer in buffers:
+                    loaded = OpenSSL.crypto.load_certificate_request(
+                        OpenSSL.crypto.FILETYPE_PEM, buffer
+                    )
+                    loaded.verify(loaded.get_pubkey())
+                    loaded.get_subject().get_components()
+                    for extension in loaded.get_extensions():
+                        str(extension)
+            else:
+                OpenSSL.crypto.validate_certificate_requests(
+                    OpenSSL.crypto.FILETYPE_PEM, buffers
+                )
+            count += len(buffers)
+            elapsed = time.perf_counter() - start
+            if elapsed >= duration:
+                break
+        results.append(
+            {
+                "method": method,
+                "requests": count,
+                "requests_per_second": count / elapsed,
+            }
+        )
+    return results
+
+
+def _private_key_speed(
+    duration: float,
+) -> typing.List[typing.Dict[str, typing.Any]]:
+    """
+    Compare loading `_SPEED_PRIVATE_KEY_COUNT` passphrase-protected keys one
+    at a time with `load_privatekey` with loading them with
+    `load_privatekeys` at several thread counts, as a server does at
+    startup.
+    """
+    from cryptography.hazmat.primitives import serialization
+    from cryptography.hazmat.primitives.asymmetric import ec
+
+    keys = []
+    for i in range(_SPEED_PRIVATE_KEY_COUNT):
+        passphrase = f"pyOpenSSL speed test {i}".encode("ascii")
+        keys.append(
+            (
+                ec.generate_private_key(ec.SECP256R1()).private_bytes(
+                    serialization.Encoding.PEM,
+                    serialization.PrivateFormat.PKCS8,
+                    serialization.BestAvailableEncryption(passphrase),
+                ),
+                passphrase,
+            )
+        )
+
+    def load_one_at_a_time(threads: int) -> None:
+        for buffer, passphrase in keys:
+            OpenSSL.crypto.load_privatekey(
+                OpenSSL.crypto.FILETYPE_PEM, buffer, passphrase
+            )
+
+    def load_in_threads(threads: int) -> None:
+        OpenSSL.crypto.load_privatekeys(
+            OpenSSL.crypto.FILETYPE_PEM, keys, max_workers=threads
+        )
+
+    results = []
+    for method, load, thread_counts in [
+        ("load_privatekey", load_one_at_a_time, [1]),
+        ("load_privatekeys", load_in_threads, _SPEED_THREADS),
+    ]:
+        for threads in thread_counts:
+            count = 0
+            start = time.perf_counter()
+            while True:
+                load(threads)
+                count += len(keys)
+                elapsed = time.perf_counter() - start
+                if elapsed >= duration:
+                    break
+            results.append(
+                {
+                    "method": method,
+                    "threads": threads,
+                    "keys_per_second": count / elapsed,
+                }
+            )
+    return results
+
+
+# The benchmarks of individual features, run with --benchmark.
+_BENCHMARKS: typing.Dict[str, typing.Callable[[float], typing.Any]] = {
+    "trust-store": _trust_store_speed,
+    "verification-scaling": _verification_scaling,
+    "crl": _crl_speed,
+    "csr": _csr_speed,
+    "private-keys": _private_key_speed,
+}
+
+
+def _speed(duration: float = 0.5) -> typing.Dict[str, typing.Any]:
+    """
+    Measure TLS 1.3 AEAD throughput and handshakes per second, spending
+    about *duration* seconds on each measurement.
+
+    Return the results and the CPU capabilities as a JSON-serializable dict.
+    """
+    rsa_key = OpenSSL.crypto.PKey()
+    rsa_key.generate_key(OpenSSL.crypto.TYPE_RSA, 2048)
+    ec_key = _speed_ec_key()
+
+    server_context, client_context = _speed_contexts(ec_key)
+    aead = []
+    for cipher in _SPEED_CIPHERS:
+        OpenSSL.SSL._openssl_assert(
+            OpenSSL._util.lib.SSL_CTX_set_ciphersuites(
+                client_context._context, cipher
+            )
+            == 1
+        )
+        for size in _SPEED_RECORD_SIZES:
+            aead.append(
+                {
+                    "cipher": cipher.decode("ascii"),
+                    "record_size": size,
+                    "bytes_per_second": _bytes_per_second(
+                        server_context, client_context, size, duration
+                    ),
+                }
+            )
+
+    handshakes = []
+    for name, key, recorder in [
+        ("rsa2048", rsa_key, False),
+        ("ecdsa-p256", ec_key, False),
+        ("ecdsa-p256", ec_key, True),
+    ]:
+        server_context, client_context = _speed_contexts(key)
+        if recorder:
+            # The overhead of Context.set_message_recorder.
+            server_context.set_message_recorder()
+            client_context.set_message_recorder()
+        handshakes.append(
+            {
+                "key": name,
+                "message_recorder": recorder,
+                "handshakes_per_second": _handshakes_per_second(
+                    server_context, client_context, duration
+                ),
+            }
+        )
+
+    return {
+        **_speed_platform(),
+        "aead": aead,
+        "handshakes": handshakes,
+    }
+
+
+def _speed_platform() -> typing.Dict[str, typing.Any]:
+    return {
+        "openssl": OpenSSL.SSL.SSLeay_version(
+            OpenSSL.SSL.SSLEAY_VERSION
+        ).decode("ascii"),
+        "cpu": _cpu_info(),
+    }
+
+
+def _main(argv: typing.Optional[typing.List[str]] = None) -> None:
+    parser = argparse.ArgumentParser(prog="python -m OpenSSL.debug")
+    parser.add_argument(
+        "--speed",
+        action="store_true",
+        help="measure cipher throughput and handshakes per second and "
+        "print them with the CPU capabilities as JSON",
+    )
+    parser.add_argument(
+        "--benchmark",
+        action="append",
+        choices=sorted(_BENCHMARKS),
+        help="also measure the performance of a feature and print it as "
+        "JSON; may be given several times",
+    )
+    parser.add_argument(
+        "--duration",
+        type=float,
+        default=0.5,
+        help="seconds to spend on each --speed or --benchmark measurement "
+        "(default: 0.5)",
+    )
+    args = parser.parse_args(argv)
+    if args.speed or args.benchmark:
+        result = _speed(args.duration) if args.speed else _speed_platform()
+        for name in args.benchmark or []:
+            result[name.replace("-", "_")] = _BENCHMARKS[name](args.duration)
+        print(json.dumps(result, indent=2))
+    else:
+        print(_env_info)
+
+
 if __name__ == "__main__":
-    print(_env_info)
+    _main()
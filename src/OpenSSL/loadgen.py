@@ -0,0 +1,507 @@
+"""
+A TLS load generator for capacity planning.
+
+Run ``python -m OpenSSL.loadgen --help`` for its options.  It runs a number
+of client/server :class:`OpenSSL.SSL.Connection` pairs concurrently, each in
+its own thread, connected over memory BIOs or a TCP loopback connection.
+Each pair repeatedly performs a handshake and then exchanges payloads.  For
+every concurrency level it reports handshakes per second, payload throughput
+and the median and 99th percentile latencies.
+"""
+
+import argparse
+import json
+import math
+import select
+import socket
+import sys
+import threading
+import time
+import typing
+
+from OpenSSL import SSL, crypto
+from OpenSSL._util import lib as _lib
+
+_KEY_TYPES = ["rsa2048", "rsa4096", "ecdsa-p256", "ecdsa-p384", "ed25519"]
+
+_PROTOCOLS = {
+    "1.2": SSL.TLS1_2_VERSION,
+    "1.3": SSL.TLS1_3_VERSION,
+}
+
+# Seconds to wait for a peer before giving up on a pair.
+_TIMEOUT = 10.0
+
+
+class _Config(typing.NamedTuple):
+    transport: str
+    protocol: str
+    cipher: typing.Optional[str]
+    key_type: str
+    cert_file: typing.Optional[str]
+    key_file: typing.Optional[str]
+    resumption: bool
+    payload_size: int
+    requests: int
+    duration: float
+
+
+def _generate_credentials(
+    key_type: str,
+) -> typing.Tuple[crypto.PKey, crypto.X509]:
+    """
+    Return a new key of *key_type* and a self-signed certificate for it.
+    """
+    import datetime
+
+    from cryptography import x509
+    from cryptography.hazmat.primitives import hashes
+    from cryptography.hazmat.primitives.asymmetric import ec, ed25519, rsa
+
+    key: typing.Any
+    algorithm: typing.Optional[hashes.HashAlgorithm] = hashes.SHA256()
+    if key_type.startswith("rsa"):
+        key = rsa.generate_private_key(
+            public_exponent=65537, key_size=int(key_type[len("rsa") :])
+        )
+    elif key_type == "ecdsa-p256":
+        key = ec.generate_private_key(ec.SECP256R1())
+    elif key_type == "ecdsa-p384":
+        key = ec.generate_private_key(ec.SECP384R1())
+    elif key_type == "ed25519":
+        key = ed25519.Ed25519PrivateKey.generate()
+        algorithm = None
+    else:
+        raise ValueError(f"Unknown key type {key_type!r}")
+
+    name = x509.Name(
+        [x509.NameAttribute(x509.NameOID.COMMON_NAME, "pyOpenSSL loadgen")]
+    )
+    now = datetime.datetime.now(datetime.timezone.utc)
+    cert = (
+        x509.CertificateBuilder()
+        .subject_name(name)
+        .issuer_name(name)
+        .public_key(key.public_key())
+        .serial_number(1)
+        .not_valid_before(now)
+        .not_valid_after(now + datetime.timedelta(days=1))
+        .sign(key, algorithm)
+    )
+    return (
+        crypto.PKey.from_cryptography_key(key),
+        crypto.X509.from_cryptography(cert),
+    )
+
+
+def _contexts(config: _Config) -> typing.Tuple[SSL.Context, SSL.Context]:
+    """
+    Return the server and client contexts for *config*.
+    """
+    server_context = SSL.Context(SSL.TLS_METHOD)
+    client_context = SSL.Context(SSL.TLS_METHOD)
+    version = _PROTOCOLS[config.protocol]
+    for context in [server_context, client_context]:
+        context.set_min_proto_version(version)
+        context.set_max_proto_version(version)
+        if config.cipher is None:
+            continue
+        if version == SSL.TLS1_3_VERSION:
+            cipher = config.cipher.encode("ascii")
+            if not _lib.SSL_CTX_set_ciphersuites(context._context, cipher):
+                raise ValueError(f"No cipher suite matches {config.cipher!r}")
+        else:
+            context.set_cipher_list(config.cipher.encode("ascii"))
+
+    if config.cert_file is not None:
+        server_context.use_certificate_chain_file(config.cert_file)
+        server_context.use_privatekey_file(config.key_file or config.cert_file)
+    else:
+        key, cert = _generate_credentials(config.key_type)
+        server_context.use_privatekey(key)
+        server_context.use_certificate(cert)
+
+    if config.resumption:
+        server_context.set_session_id(b"pyOpenSSL loadgen")
+    else:
+        server_context.set_session_cache_mode(SSL.SESS_CACHE_OFF)
+        server_context.set_options(SSL.OP_NO_TICKET)
+    return server_context, client_context
+
+
+def _loopback_sockets() -> typing.Tuple[socket.socket, socket.socket]:
+    """
+    Return the server and client ends of a new TCP connection over
+    127.0.0.1, so the pairs pay the same kernel costs as real clients.
+    """
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    try:
+        listener.bind(("127.0.0.1", 0))
+        listener.listen(1)
+        client_socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        client_socket.connect(listener.getsockname())
+        server_socket = listener.accept()[0]
+    finally:
+        listener.close()
+    for sock in [server_socket, client_socket]:
+        # Without this, Nagle's algorithm holds back the small handshake
+        # flights and requests until the peer's delayed ACK.
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        sock.setblocking(False)
+    return server_socket, client_socket
+
+
+class _Pair:
+    """
+    A connected client and server, and a function that moves their data.
+    """
+
+    def __init__(
+        self,
+        config: _Config,
+        server_context: SSL.Context,
+        client_context: SSL.Context,
+    ) -> None:
+        self._sockets: typing.List[socket.socket] = []
+        if config.transport == "socket":
+            server_socket, client_socket = _loopback_sockets()
+            self._sockets.extend([server_socket, client_socket])
+            self.server = SSL.Connection(server_context, server_socket)
+            self.client = SSL.Connection(client_context, client_socket)
+        else:
+            self.server = SSL.Connection(server_context, None)
+            self.client = SSL.Connection(client_context, None)
+        self.server.set_accept_state()
+        self.client.set_connect_state()
+
+    def pump(self) -> None:
+        """
+        Move pending bytes between memory BIOs.  Sockets need no help.
+        """
+        if self._sockets:
+            return
+        for source, sink in [
+            (self.client, self.server),
+            (self.server, self.client),
+        ]:
+            try:
+                sink.bio_write(source.bio_read(2**16))
+            except SSL.WantReadError:
+                pass
+
+    def wait(
+        self,
+        readers: typing.List[SSL.Connection],
+        writers: typing.List[SSL.Connection],
+    ) -> None:
+        """
+        Block until one of *readers* can read or one of *writers* can write.
+        Memory BIOs never need to wait.
+        """
+        if not self._sockets:
+            return
+        ready = select.select(readers, writers, [], _TIMEOUT)
+        if not any(ready):
+            raise RuntimeError("Timed out waiting for the peer")
+
+    def handshake(self) -> None:
+        pending = [self.client, self.server]
+        while pending:
+            for conn in list(pending):
+                try:
+                    conn.do_handshake()
+                    pending.remove(conn)
+                except SSL.WantReadError:
+                    pass
+            self.pump()
+            if pending:
+                self.wait(pending, [])
+
+    def transfer(
+        self, sender: SSL.Connection, receiver: SSL.Connection, data: bytes
+    ) -> None:
+        view = memoryview(data)
+        buf = bytearray(2**16)
+        sent = received = 0
+        while received < len(data):
+            progress = False
+            if sent < len(data):
+                try:
+                    sent += sender.send(view[sent : sent + 2**14])
+                    progress = True
+                except (SSL.WantReadError, SSL.WantWriteError):
+                    pass
+            self.pump()
+            try:
+                received += receiver.recv_into(buf)
+                progress = True
+            except SSL.WantReadError:
+                pass
+            if not progress:
+                self.wait([receiver], [sender] if sent < len(data) else [])
+
+    def shutdown(self) -> None:
+        """
+        Send close_notify alerts both ways.  OpenSSL does not resume
+        sessions of connections that were not shut down.
+        """
+        self.client.shutdown()
+        self.server.shutdown()
+        self.pump()
+
+    def close(self) -> None:
+        for sock in self._sockets:
+            sock.close()
+
+
+class _Stats:
+    def __init__(self) -> None:
+        self.lock = threading.Lock()
+        self.handshake_latencies: typing.List[float] = []
+        self.request_latencies: typing.List[float] = []
+        self.bytes = 0
+
+
+def _worker(
+    config: _Config,
+    server_context: SSL.Context,
+    client_context: SSL.Context,
+    deadline: float,
+    stats: _Stats,
+) -> None:
+    """
+    Run handshakes and exchanges until *deadline*, adding to *stats*.
+    """
+    payload = b"\0" * config.payload_size
+    session = None
+    handshake_latencies = []
+    request_latencies = []
+    transferred = 0
+    while True:
+        pair = _Pair(config, server_context, client_context)
+        try:
+            if session is not None:
+                pair.client.set_session(session)
+            start = time.perf_counter()
+            pair.handshake()
+            handshake_latencies.append(time.perf_counter() - start)
+            for _ in range(config.requests):
+                start = time.perf_counter()
+                pair.transfer(pair.client, pair.server, payload)
+                pair.transfer(pair.server, pair.client, payload)
+                request_latencies.append(time.perf_counter() - start)
+                transferred += 2 * len(payload)
+            pair.shutdown()
+            if config.resumption:
+                session = pair.client.get_session()
+        finally:
+            pair.close()
+        if time.perf_counter() >= deadline:
+            break
+
+    with stats.lock:
+        stats.handshake_latencies.extend(handshake_latencies)
+        stats.request_latencies.extend(request_latencies)
+        stats.bytes += transferred
+
+
+def _percentile(
+    values: typing.List[float], q: float
+) -> typing.Optional[float]:
+    """
+    Return the *q* quantile of *values* by the nearest-rank method, or
+    ``None`` if there are none.
+    """
+    if not values:
+        return None
+    ordered = sorted(values)
+    rank = max(1, math.ceil(q * len(ordered)))
+    return ordered[rank - 1]
+
+
+def _milliseconds(seconds: typing.Optional[float]) -> typing.Optional[float]:
+    return None if seconds is None else seconds * 1000
+
+
+def _run(config: _Config, concurrency: int) -> typing.Dict[str, typing.Any]:
+    """
+    Run *concurrency* connection pairs for ``config.duration`` seconds and
+    return the results.
+    """
+    server_context, client_context = _contexts(config)
+    stats = _Stats()
+    start = time.perf_counter()
+    deadline = start + config.duration
+    errors: typing.List[BaseException] = []
+
+    def target() -> None:
+        try:
+            _worker(config, server_context, client_context, deadline, stats)
+        except BaseException as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=target) for _ in range(concurrency)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+    if errors:
+        raise errors[0]
+
+    return {
+        "concurrency": concurrency,
+        "handshakes": len(stats.handshake_latencies),
+        "handshakes_per_second": len(stats.handshake_latencies) / elapsed,
+        "megabytes_per_second": stats.bytes / elapsed / 1e6,
+        "handshake_p50_ms": _milliseconds(
+            _percentile(stats.handshake_latencies, 0.5)
+        ),
+        "handshake_p99_ms": _milliseconds(
+            _percentile(stats.handshake_latencies, 0.99)
+        ),
+        "request_p50_ms": _milliseconds(
+            _percentile(stats.request_latencies, 0.5)
+        ),
+        "request_p99_ms": _milliseconds(
+            _percentile(stats.request_latencies, 0.99)
+        ),
+    }
+
+
+def _format_table(results: typing.List[typing.Dict[str, typing.Any]]) -> str:
+    columns = [
+        ("concurrency", "concurrency"),
+        ("handshakes/s", "handshakes_per_second"),
+        ("MB/s", "megabytes_per_second"),
+        ("hs p50 ms", "handshake_p50_ms"),
+        ("hs p99 ms", "handshake_p99_ms"),
+        ("req p50 ms", "request_p50_ms"),
+        ("req p99 ms", "request_p99_ms"),
+    ]
+    rows = [[title for title, _ in columns]]
+    for result in results:
+        row = []
+        for _, key in columns:
+            value = result[key]
+            if value is None:
+                row.append("-")
+            elif isinstance(value, float):
+                row.append(f"{value:.2f}")
+            else:
+                row.append(str(value))
+        rows.append(row)
+    widths = [max(len(row[i]) for row in rows) for i in range(len(columns))]
+    return "\n".join(
+        "  ".join(cell.rjust(width) for cell, width in zip(row, widths))
+        for row in rows
+    )
+
+
+def _concurrency_levels(value: str) -> typing.List[int]:
+    levels = [int(level) for level in value.split(",")]
+    if any(level < 1 for level in levels):
+        raise argparse.ArgumentTypeError("concurrency levels must be >= 1")
+    return levels
+
+
+def _main(argv: typing.Optional[typing.List[str]] = None) -> None:
+    parser = argparse.ArgumentParser(
+        prog="python -m OpenSSL.loadgen",
+        description="Measure TLS handshakes per second, throughput and "
+        "latency with pyOpenSSL.",
+    )
+    parser.add_argument(
+        "--transport",
+        choices=["memory", "socket"],
+        default="memory",
+        help="connect the pairs over memory BIOs or TCP over 127.0.0.1 "
+        "(default: memory)",
+    )
+    parser.add_argument(
+        "--concurrency",
+        type=_concurrency_levels,
+        default=[1],
+        help="comma-separated numbers of concurrent connection pairs to "
+        "run, one after another (default: 1)",
+    )
+    parser.add_argument(
+        "--protocol", choices=sorted(_PROTOCOLS), default="1.3"
+    )
+    parser.add_argument(
+        "--cipher",
+        help="the cipher list (TLS 1.2) or cipher suites (TLS 1.3) to use",
+    )
+    parser.add_argument(
+        "--key-type",
+        choices=_KEY_TYPES,
+        default="ecdsa-p256",
+        help="the key type of the generated server certificate "
+        "(default: ecdsa-p256)",
+    )
+    parser.add_argument(
+        "--cert",
+        dest="cert_file",
+        help="a PEM certificate chain file to use instead of a generated "
+        "certificate",
+    )
+    parser.add_argument(
+        "--key",
+        dest="key_file",
+        help="the PEM private key file for --cert (default: the --cert file)",
+    )
+    parser.add_argument(
+        "--resumption",
+        action="store_true",
+        help="resume the previous session of each pair",
+    )
+    parser.add_argument(
+        "--payload-size",
+        type=int,
+        default=1024,
+        help="bytes sent each way per request (default: 1024)",
+    )
+    parser.add_argument(
+        "--requests",
+        type=int,
+        default=1,
+        help="requests per connection (default: 1)",
+    )
+    parser.add_argument(
+        "--duration",
+        type=float,
+        default=5.0,
+        help="seconds to run each concurrency level (default: 5)",
+    )
+    parser.add_argument(
+        "--json", action="store_true", help="print the results as JSON"
+    )
+    args = parser.parse_args(argv)
+    if args.key_file is not None and args.cert_file is None:
+        parser.error("--key requires --cert")
+
+    config = _Config(
+        transport=args.transport,
+        protocol=args.protocol,
+        cipher=args.cipher,
+        key_type=args.key_type,
+        cert_file=args.cert_file,
+        key_file=args.key_file,
+        resumption=args.resumption,
+        payload_size=args.payload_size,
+        requests=args.requests,
+        duration=args.duration,
+    )
+    results = []
+    for concurrency in args.concurrency:
+        results.append(_run(config, concurrency))
+
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        sys.stdout.write("\n")
+    else:
+        print(_format_table(results))
+
+
+if __name__ == "__main__":
+    _main()
@@ -6,6 +6,9 @@ Unit tests for :py:mod:`OpenSSL.crypto`.
 """
 
 import base64
+import io
+import mmap
+import pickle
 import sys
 import warnings
 from datetime import datetime, timedelta, timezone
@@ -27,24 +30,35 @@ from OpenSSL.crypto import (
     X509,
     Error,
     PKey,
+    X509IntermediatePool,
+    X509LazyStore,
     X509Name,
     X509Req,
     X509Store,
     X509StoreContext,
     X509StoreContextError,
     X509StoreFlags,
+    digest_certificates,
     dump_certificate,
+    dump_certificate_batch,
     dump_certificate_request,
     dump_privatekey,
     dump_publickey,
+    find_expiring_certificates,
     get_elliptic_curve,
     get_elliptic_curves,
     load_certificate,
+    load_certificate_batch,
     load_certificate_request,
+    load_certificates,
     load_privatekey,
+    load_privatekeys,
     load_publickey,
     sign,
+    validate_certificate_requests,
     verify,
+    verify_certificates,
+    write_crl,
 )
 
 with pytest.warns(DeprecationWarning):
@@ -1187,6 +1201,47 @@ class TestPKey:
             pkey = load_privatekey(FILETYPE_PEM, rsa_p_not_prime_pem)
             pkey.check()
 
+    def test_pickle_public_key(self):
+        """
+        A public-only `PKey` round-trips through `pickle`.
+        """
+        key = load_publickey(FILETYPE_PEM, cleartextPublicKeyPEM)
+        copy = pickle.loads(pickle.dumps(key))
+        assert copy._only_public
+        assert dump_publickey(FILETYPE_PEM, copy) == dump_publickey(
+            FILETYPE_PEM, key
+        )
+
+    def test_pickle_private_key_refused(self):
+        """
+        Pickling a `PKey` holding a private key raises `TypeError` unless
+        `PKey.set_private_pickling` allowed it.
+        """
+        key = load_privatekey(FILETYPE_PEM, root_key_pem)
+        with pytest.raises(TypeError):
+            pickle.dumps(key)
+
+    def test_pickle_private_key_allowed(self):
+        """
+        Once allowed, a private `PKey` round-trips through `pickle` and the
+        copy does not inherit the permission.
+        """
+        key = load_privatekey(FILETYPE_PEM, root_key_pem)
+        key.set_private_pickling(True)
+        copy = pickle.loads(pickle.dumps(key))
+        assert dump_privatekey(FILETYPE_PEM, copy) == dump_privatekey(
+            FILETYPE_PEM, key
+        )
+        with pytest.raises(TypeError):
+            pickle.dumps(copy)
+
+    def test_pickle_uninitialized(self):
+        """
+        Pickling a `PKey` without a key raises `TypeError`.
+        """
+        with pytest.raises(TypeError):
+            pickle.dumps(PKey())
+
 
 def x509_name(**attrs):
     """
@@ -1706,6 +1761,18 @@ class TestX509Req(_PKeyInteractionTestsMixin):
         crypto_req = req.to_cryptography()
         assert isinstance(crypto_req, x509.CertificateSigningRequest)
 
+    def test_pickle(self):
+        """
+        `X509Req` round-trips through `pickle`.
+        """
+        req = load_certificate_request(
+            FILETYPE_PEM, cleartextCertificateRequestPEM
+        )
+        copy = pickle.loads(pickle.dumps(req))
+        assert dump_certificate_request(
+            FILETYPE_ASN1, copy
+        ) == dump_certificate_request(FILETYPE_ASN1, req)
+
 
 class TestX509(_PKeyInteractionTestsMixin):
     """
@@ -1853,6 +1920,41 @@ class TestX509(_PKeyInteractionTestsMixin):
         cert = load_certificate(FILETYPE_PEM, old_root_cert_pem)
         assert cert.get_notAfter() == b"20170611123658Z"
 
+    def test_get_timestamps(self):
+        """
+        `X509.get_notBefore_timestamp` and `X509.get_notAfter_timestamp`
+        return the validity period in seconds since the epoch, even for
+        certificates which store it as UTCTIME internally.
+        """
+        cert = load_certificate(FILETYPE_PEM, old_root_cert_pem)
+        utc = timezone.utc
+        assert cert.get_notBefore_timestamp() == int(
+            datetime(2009, 3, 25, 12, 36, 58, tzinfo=utc).timestamp()
+        )
+        assert cert.get_notAfter_timestamp() == int(
+            datetime(2017, 6, 11, 12, 36, 58, tzinfo=utc).timestamp()
+        )
+
+    def test_get_timestamps_generalized(self):
+        """
+        `X509.get_notAfter_timestamp` handles years past 2049, which are
+        stored as GENERALIZEDTIME.
+        """
+        cert = X509()
+        cert.set_notAfter(b"20600229235959Z")
+        assert cert.get_notAfter_timestamp() == int(
+            datetime(2060, 2, 29, 23, 59, 59, tzinfo=timezone.utc).timestamp()
+        )
+
+    def test_get_timestamps_unset(self):
+        """
+        `X509.get_notBefore_timestamp` and `X509.get_notAfter_timestamp`
+        return ``None`` if the time is not set.
+        """
+        cert = X509()
+        assert cert.get_notBefore_timestamp() is None
+        assert cert.get_notAfter_timestamp() is None
+
     def test_gmtime_adj_notBefore_wrong_args(self):
         """
         `X509.gmtime_adj_notBefore` raises `TypeError` if called with a
@@ -2232,6 +2334,16 @@ tgI5
         assert isinstance(crypto_cert, x509.Certificate)
         assert crypto_cert.version.value == cert.get_version()
 
+    def test_pickle(self):
+        """
+        `X509` round-trips through `pickle`.
+        """
+        cert = load_certificate(FILETYPE_PEM, intermediate_cert_pem)
+        copy = pickle.loads(pickle.dumps(cert))
+        assert isinstance(copy, X509)
+        assert dump_certificate(FILETYPE_PEM, copy) == intermediate_cert_pem
+        assert copy.get_subject() == cert.get_subject()
+
 
 class TestX509Store:
     """
@@ -2334,6 +2446,105 @@ class TestX509Store:
         with pytest.raises(Error):
             store.load_locations(cafile=str(invalid_ca_file))
 
+    def test_replicate_per_thread(self):
+        """
+        After `X509Store.replicate_per_thread` concurrent verifications use
+        different copies of the store, which are kept for later ones.
+        """
+        root = load_certificate(FILETYPE_PEM, root_cert_pem)
+        intermediate = load_certificate(FILETYPE_PEM, intermediate_cert_pem)
+        store = X509Store()
+        store.replicate_per_thread()
+        store.add_cert(root)
+        store.add_cert(intermediate)
+
+        first = store._acquire_store()
+        second = store._acquire_store()
+        assert len({id(store._store), id(first), id(second)}) == 3
+        store._release_store(first)
+        store._release_store(second)
+
+        X509StoreContext(store, intermediate).verify_certificate()
+        assert (
+            verify_certificates(store, [intermediate] * 8, None, 2)
+            == [None] * 8
+        )
+        replicas = {id(replica) for replica in store._replicas}
+        assert {id(first), id(second)} <= replicas
+        assert len(replicas) <= 3
+        verify_certificates(store, [intermediate] * 8, None, 2)
+        assert {id(replica) for replica in store._replicas} == replicas
+
+    def test_replicate_per_thread_settings(self):
+        """
+        Replicas of a store use its verification time and flags.
+        """
+        cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+        store = X509Store()
+        store.replicate_per_thread()
+        store.add_cert(cert)
+        store.set_time(datetime(2100, 1, 1))
+        with pytest.raises(X509StoreContextError) as exc:
+            X509StoreContext(store, cert).verify_certificate()
+        assert exc.value.args[0] == "certificate has expired"
+
+    def test_replicate_per_thread_load_locations(self, tmpdir):
+        """
+        Replicas use the certificates read by `X509Store.load_locations`
+        without reading the file again, and do not repeat a load which
+        failed.
+        """
+        cafile = tmpdir.join("ca.pem")
+        cafile.write(root_cert_pem)
+        store = X509Store()
+        store.replicate_per_thread()
+        with pytest.raises(Error):
+            store.load_locations(None, None)
+        store.load_locations(str(cafile))
+        cafile.remove()
+
+        cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+        assert verify_certificates(store, [cert] * 2, max_workers=2) == [
+            None,
+            None,
+        ]
+
+    def test_replicate_per_thread_read_only(self):
+        """
+        A store replicated per thread cannot be modified once it has been used
+        for a verification.
+        """
+        cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+        store = X509Store()
+        store.replicate_per_thread()
+        store.add_cert(cert)
+        X509StoreContext(store, cert).verify_certificate()
+        with pytest.raises(ValueError):
+            store.add_cert(cert)
+        with pytest.raises(ValueError):
+            store.set_flags(X509StoreFlags.CRL_CHECK)
+
+    def test_replicate_per_thread_not_empty(self):
+        """
+        `X509Store.replicate_per_thread` raises `ValueError` for a store
+        which something has been added to.
+        """
+        store = X509Store()
+        store.set_flags(X509StoreFlags.CRL_CHECK)
+        with pytest.raises(ValueError):
+            store.replicate_per_thread()
+
+    def test_replicate_per_thread_wrapped(self):
+        """
+        `X509Store.replicate_per_thread` raises `ValueError` for a store which
+        was not created by `X509Store`.
+        """
+        store = X509Store.__new__(X509Store)
+        store._store = _lib.X509_STORE_new()
+        with pytest.raises(ValueError):
+            store.replicate_per_thread()
+        _lib.X509_STORE_free(store._store)
+
 
 def _runopenssl(pem, *args):
     """
@@ -2349,6 +2560,196 @@ def _runopenssl(pem, *args):
     return output
 
 
+class TestX509LazyStore:
+    """
+    Tests for `OpenSSL.crypto.X509LazyStore`.
+    """
+
+    root_cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+    intermediate_cert = load_certificate(FILETYPE_PEM, intermediate_cert_pem)
+    intermediate_server_cert = load_certificate(
+        FILETYPE_PEM, intermediate_server_cert_pem
+    )
+
+    def _verified_subjects(self, store):
+        store_ctx = X509StoreContext(
+            store, self.intermediate_server_cert, [self.intermediate_cert]
+        )
+        return [
+            cert.get_subject().CN for cert in store_ctx.get_verified_chain()
+        ]
+
+    def test_add_cert_batch(self):
+        """
+        `X509LazyStore.add_cert_batch` adds trusted certificates which are
+        decoded only once a verification looks them up.
+        """
+        server_cert = load_certificate(FILETYPE_PEM, server_cert_pem)
+        store = X509LazyStore()
+        store.add_cert_batch(
+            dump_certificate_batch([server_cert, self.root_cert])
+        )
+        assert not any(
+            isinstance(entry, X509)
+            for entries in store._index.values()
+            for entry in entries
+        )
+
+        assert self._verified_subjects(store) == [
+            "intermediate-service",
+            "intermediate",
+            "Testing Root CA",
+        ]
+        decoded = [
+            entry.get_subject().CN
+            for entries in store._index.values()
+            for entry in entries
+            if isinstance(entry, X509)
+        ]
+        assert decoded == ["Testing Root CA"]
+        assert (
+            verify_certificates(
+                store,
+                [self.intermediate_server_cert] * 4,
+                [self.intermediate_cert],
+            )
+            == [None] * 4
+        )
+
+    def test_add_cert(self):
+        """
+        Certificates added with `X509LazyStore.add_cert` are trusted too.
+        """
+        store = X509LazyStore()
+        store.add_cert(self.root_cert)
+        assert self._verified_subjects(store)[-1] == "Testing Root CA"
+
+    def test_untrusted(self):
+        """
+        Verification fails if the store has no issuer for the chain.
+        """
+        store = X509LazyStore()
+        store.add_cert_batch(dump_certificate_batch([self.intermediate_cert]))
+        store_ctx = X509StoreContext(store, self.intermediate_server_cert)
+        with pytest.raises(X509StoreContextError):
+            store_ctx.verify_certificate()
+
+    def test_key_identifier(self):
+        """
+        Where several trusted certificates share a subject name, the authority
+        key identifier selects the right one.
+        """
+        root, first, second, leaf = TestX509StoreContext._key_id_chain()
+        store = X509LazyStore()
+        store.add_cert_batch(dump_certificate_batch([first, root, second]))
+        chain = X509StoreContext(store, leaf).get_verified_chain()
+        assert [cert.digest("sha256") for cert in chain] == [
+            cert.digest("sha256") for cert in [leaf, second, root]
+        ]
+
+    def test_expired_issuer(self):
+        """
+        Where several trusted certificates share a subject name, one that did
+        not issue the certificate is skipped, and one that is valid at the
+        verification time is preferred over an expired one.
+        """
+        now = datetime.now(timezone.utc)
+        name = x509.Name.from_rfc4514_string("CN=lazy root")
+
+        def root(key, not_before, not_after):
+            builder = (
+                x509.CertificateBuilder()
+                .subject_name(name)
+                .issuer_name(name)
+                .public_key(key.public_key())
+                .serial_number(x509.random_serial_number())
+                .not_valid_before(not_before)
+                .not_valid_after(not_after)
+                .add_extension(
+                    x509.BasicConstraints(ca=True, path_length=None), True
+                )
+            )
+            return X509.from_cryptography(builder.sign(key, hashes.SHA256()))
+
+        key, other_key, leaf_key = (
+            ec.generate_private_key(ec.SECP256R1()) for _ in range(3)
+        )
+        day = timedelta(days=1)
+        unrelated = root(other_key, now - day, now + day)
+        expired = root(key, now - 10 * day, now - 5 * day)
+        valid = root(key, now - day, now + day)
+        leaf = TestX509StoreContext._issue(
+            "CN=lazy leaf", leaf_key, "CN=lazy root", key, False
+        )
+
+        store = X509LazyStore()
+        store.add_cert_batch(
+            dump_certificate_batch([unrelated, expired, valid])
+        )
+        chain = X509StoreContext(store, leaf).get_verified_chain()
+        assert [cert.digest("sha256") for cert in chain] == [
+            cert.digest("sha256") for cert in [leaf, valid]
+        ]
+
+        store = X509LazyStore()
+        store.add_cert_batch(dump_certificate_batch([unrelated, expired]))
+        with pytest.raises(X509StoreContextError) as exc:
+            X509StoreContext(store, leaf).verify_certificate()
+        assert exc.value.certificate.digest("sha256") == expired.digest(
+            "sha256"
+        )
+
+    def test_mmap(self, tmp_path):
+        """
+        `X509LazyStore.add_cert_batch` accepts a memory mapped file.
+        """
+        path = tmp_path / "roots"
+        path.write_bytes(dump_certificate_batch([self.root_cert]))
+        with open(path, "rb") as f:
+            mapping = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        store = X509LazyStore()
+        store.add_cert_batch(mapping)
+        assert self._verified_subjects(store)[-1] == "Testing Root CA"
+
+    @pytest.mark.parametrize("cut", [2, 6, 20])
+    def test_add_cert_batch_truncated(self, cut):
+        """
+        `X509LazyStore.add_cert_batch` raises `ValueError` for a truncated
+        batch.
+        """
+        batch = dump_certificate_batch([self.root_cert])
+        with pytest.raises(ValueError):
+            X509LazyStore().add_cert_batch(batch[:cut])
+
+    def test_add_cert_batch_malformed(self):
+        """
+        `X509LazyStore.add_cert_batch` raises `ValueError` when a record is
+        not a DER certificate.
+        """
+        with pytest.raises(ValueError):
+            X509LazyStore().add_cert_batch(
+                b"\x00\x00\x00\x01\x00\x00\x00\x03abc"
+            )
+
+    def test_load_locations(self, tmpdir):
+        """
+        `X509LazyStore.load_locations` raises `NotImplementedError`.
+        """
+        with pytest.raises(NotImplementedError):
+            X509LazyStore().load_locations(str(tmpdir))
+
+    def test_replicate_per_thread(self):
+        """
+        Replicas of an `X509LazyStore` have its batches.
+        """
+        store = X509LazyStore()
+        store.replicate_per_thread()
+        store.add_cert_batch(dump_certificate_batch([self.root_cert]))
+        assert self._verified_subjects(store)[-1] == "Testing Root CA"
+        with pytest.raises(ValueError):
+            store.add_cert_batch(dump_certificate_batch([self.root_cert]))
+
+
 class TestLoadPublicKey:
     """
     Tests for :func:`load_publickey`.
@@ -2613,6 +3014,452 @@ class TestFunction:
         with pytest.raises(ValueError):
             dump_certificate(object(), cert)
 
+    def test_certificate_batch_roundtrip(self):
+        """
+        `load_certificate_batch` returns the certificates passed to
+        `dump_certificate_batch`, in order, from any buffer object and
+        ignoring trailing padding.
+        """
+        pems = [root_cert_pem, intermediate_cert_pem, server_cert_pem]
+        certs = [load_certificate(FILETYPE_PEM, pem) for pem in pems]
+        batch = dump_certificate_batch(certs)
+        padded = bytearray(batch) + bytearray(4096)
+        for buffer in [batch, memoryview(padded)]:
+            loaded = load_certificate_batch(buffer)
+            assert [dump_certificate(FILETYPE_PEM, c) for c in loaded] == pems
+
+    def test_certificate_batch_empty(self):
+        """
+        An empty batch loads as an empty list.
+        """
+        assert load_certificate_batch(dump_certificate_batch([])) == []
+
+    @pytest.mark.parametrize("cut", [2, 6, 20])
+    def test_certificate_batch_truncated(self, cut):
+        """
+        `load_certificate_batch` raises `ValueError` for a truncated batch.
+        """
+        cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+        batch = dump_certificate_batch([cert])
+        with pytest.raises(ValueError):
+            load_certificate_batch(batch[:cut])
+
+    def test_certificate_batch_garbage(self):
+        """
+        `load_certificate_batch` raises `OpenSSL.crypto.Error` when a record
+        is not a DER certificate.
+        """
+        batch = b"\x00\x00\x00\x01\x00\x00\x00\x03abc"
+        with pytest.raises(Error):
+            load_certificate_batch(batch)
+
+    @pytest.mark.parametrize("max_workers", [None, 1, 2, 8])
+    def test_load_certificates(self, max_workers):
+        """
+        `load_certificates` loads every buffer and returns the certificates
+        in input order, whatever the number of threads.
+        """
+        pems = [root_cert_pem, intermediate_cert_pem, server_cert_pem] * 5
+        ders = [
+            dump_certificate(FILETYPE_ASN1, load_certificate(FILETYPE_PEM, p))
+            for p in pems
+        ]
+        certs = load_certificates(FILETYPE_ASN1, ders, max_workers)
+        assert [dump_certificate(FILETYPE_PEM, c) for c in certs] == pems
+
+    def test_load_certificates_error(self):
+        """
+        `load_certificates` raises `OpenSSL.crypto.Error` if any buffer is not
+        a certificate.
+        """
+        with pytest.raises(Error):
+            load_certificates(
+                FILETYPE_PEM, [root_cert_pem, b"junk", server_cert_pem], 3
+            )
+
+    def test_load_certificates_invalid(self):
+        """
+        `load_certificates` raises `ValueError` for an unknown file type or a
+        non-positive number of threads.
+        """
+        with pytest.raises(ValueError):
+            load_certificates(FILETYPE_TEXT, [root_cert_pem])
+        with pytest.raises(ValueError):
+            load_certificates(FILETYPE_PEM, [root_cert_pem] * 2, 0)
+
+    def test_digest_certificates(self):
+        """
+        `digest_certificates` returns the same digests as `X509.digest`, in
+        input order.
+        """
+        certs = [
+            load_certificate(FILETYPE_PEM, pem)
+            for pem in [root_cert_pem, intermediate_cert_pem, server_cert_pem]
+        ] * 3
+        expected = [cert.digest("sha256") for cert in certs]
+        assert digest_certificates(certs, "sha256", 4) == expected
+
+    def test_digest_certificates_unknown_digest(self):
+        """
+        `digest_certificates` raises `ValueError` for an unknown digest.
+        """
+        cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+        with pytest.raises(ValueError):
+            digest_certificates([cert], "monkeys")
+
+    @staticmethod
+    def _expiring_certs():
+        """
+        Return certificates which expire in 10, 100 and 1000 seconds and one
+        which has already expired, in that order.
+        """
+        key = load_privatekey(FILETYPE_PEM, root_key_pem)
+        certs = []
+        for seconds in [10, 100, 1000, -10]:
+            cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+            cert.gmtime_adj_notAfter(seconds)
+            cert.sign(key, "sha256")
+            certs.append(cert)
+        return certs
+
+    @pytest.mark.parametrize("max_workers", [None, 1, 3])
+    def test_find_expiring_certificates(self, max_workers):
+        """
+        `find_expiring_certificates` returns the certificates whose not-after
+        time falls before the end of the window, in input order, whatever the
+        number of threads.
+        """
+        certs = self._expiring_certs()
+        found = find_expiring_certificates(certs, 500, None, max_workers)
+        assert found == [certs[0], certs[1], certs[3]]
+
+    def test_find_expiring_certificates_now(self):
+        """
+        The window of `find_expiring_certificates` starts at *now*.
+        """
+        certs = self._expiring_certs()
+        not_after = certs[1].get_notAfter_timestamp()
+        assert find_expiring_certificates(certs, 0, not_after - 1) == [
+            certs[0],
+            certs[3],
+        ]
+        assert find_expiring_certificates(certs, 0, not_after) == [
+            certs[0],
+            certs[1],
+            certs[3],
+        ]
+
+    def test_find_expiring_certificates_unset(self):
+        """
+        `find_expiring_certificates` skips certificates without a not-after
+        time.
+        """
+        assert find_expiring_certificates([X509()], 100) == []
+
+    @pytest.mark.parametrize("max_workers", [1, 2])
+    def test_find_expiring_certificates_directory(self, tmp_path, max_workers):
+        """
+        `find_expiring_certificates` scans the DER and PEM files in a
+        directory in name order, including PEM files with several
+        certificates.
+        """
+        certs = self._expiring_certs()
+        (tmp_path / "a.pem").write_bytes(
+            dump_certificate(FILETYPE_PEM, certs[2])
+            + dump_certificate(FILETYPE_PEM, certs[0])
+        )
+        (tmp_path / "b.der").write_bytes(
+            dump_certificate(FILETYPE_ASN1, certs[3])
+        )
+        (tmp_path / "c.pem").write_bytes(
+            dump_certificate(FILETYPE_PEM, certs[1])
+        )
+        (tmp_path / "subdirectory").mkdir()
+
+        for directory in [tmp_path, str(tmp_path)]:
+            found = find_expiring_certificates(
+                directory, 500, None, max_workers
+            )
+            assert [c.get_notAfter() for c in found] == [
+                certs[0].get_notAfter(),
+                certs[3].get_notAfter(),
+                certs[1].get_notAfter(),
+            ]
+
+    @pytest.mark.parametrize(
+        "contents",
+        [
+            b"junk",
+            b"-----BEGIN junk",
+            root_cert_pem + root_cert_pem[:200],
+            root_cert_pem + b"-----BEGIN CERTIFICATE-----\n!!!!\n",
+        ],
+    )
+    def test_find_expiring_certificates_directory_error(
+        self, tmp_path, contents
+    ):
+        """
+        `find_expiring_certificates` raises `OpenSSL.crypto.Error` if a file
+        in the directory is not a certificate, or has a corrupt or truncated
+        certificate after a good one.
+        """
+        (tmp_path / "junk").write_bytes(contents)
+        with pytest.raises(Error):
+            find_expiring_certificates(tmp_path, 100)
+
+    @staticmethod
+    def _certificate_request(key, names=(), extension=None):
+        """
+        Return the DER encoding of a certificate signing request for *key*
+        with the subject alternative names *names*, or the subjectAltName
+        extension *extension*.
+        """
+        builder = x509.CertificateSigningRequestBuilder().subject_name(
+            x509.Name(
+                [
+                    x509.NameAttribute(x509.NameOID.COUNTRY_NAME, "US"),
+                    x509.NameAttribute(x509.NameOID.COMMON_NAME, "example"),
+                ]
+            )
+        )
+        if names:
+            builder = builder.add_extension(
+                x509.SubjectAlternativeName(list(names)), critical=False
+            )
+        if extension is not None:
+            builder = builder.add_extension(extension, critical=False)
+        algorithm = (
+            None
+            if isinstance(
+                key, (ed25519.Ed25519PrivateKey, ed448.Ed448PrivateKey)
+            )
+            else hashes.SHA256()
+        )
+        return builder.sign(key, algorithm).public_bytes(
+            serialization.Encoding.DER
+        )
+
+    @pytest.mark.parametrize("max_workers", [None, 1, 3])
+    def test_validate_certificate_requests(self, max_workers):
+        """
+        `validate_certificate_requests` returns the subject, subject
+        alternative names and key of each request, in input order, whatever
+        the number of threads.
+        """
+        import ipaddress
+
+        rsa_key = load_privatekey(
+            FILETYPE_PEM, root_key_pem
+        ).to_cryptography_key()
+        requests = [
+            self._certificate_request(
+                rsa_key,
+                [
+                    x509.DNSName("example.com"),
+                    x509.IPAddress(ipaddress.ip_address("192.0.2.1")),
+                    x509.IPAddress(ipaddress.ip_address("2001:db8::1")),
+                    x509.RFC822Name("admin@example.com"),
+                    x509.DNSName("www.example.com"),
+                ],
+            ),
+            self._certificate_request(ec.generate_private_key(ec.SECP384R1())),
+            self._certificate_request(ed25519.Ed25519PrivateKey.generate()),
+            self._certificate_request(ed448.Ed448PrivateKey.generate()),
+        ]
+        infos = validate_certificate_requests(
+            FILETYPE_ASN1, requests, max_workers
+        )
+        assert [info.subject for info in infos] == [
+            ((b"C", b"US"), (b"CN", b"example"))
+        ] * 4
+        assert infos[0].dns_names == ("example.com", "www.example.com")
+        assert infos[0].ip_addresses == ("192.0.2.1", "2001:db8::1")
+        assert infos[0].email_addresses == ("admin@example.com",)
+        assert infos[1].dns_names == ()
+        assert [(info.key_type, info.key_bits) for info in infos] == [
+            ("rsa", 3072),
+            ("ec", 384),
+            ("ed25519", 256),
+            ("ed448", 456),
+        ]
+        assert all(info.signature_valid for info in infos)
+
+    def test_validate_certificate_requests_pem(self):
+        """
+        `validate_certificate_requests` reads PEM requests and gives the same
+        result as `X509Req`.
+        """
+        (info,) = validate_certificate_requests(
+            FILETYPE_PEM, [cleartextCertificateRequestPEM]
+        )
+        req = load_certificate_request(
+            FILETYPE_PEM, cleartextCertificateRequestPEM
+        )
+        assert info.subject == tuple(req.get_subject().get_components())
+        assert info.key_type == "rsa"
+        assert info.key_bits == req.get_pubkey().bits()
+        assert info.signature_valid == req.verify(req.get_pubkey())
+
+    def test_validate_certificate_requests_bad_signature(self):
+        """
+        `validate_certificate_requests` reports a request whose signature
+        does not match its key as invalid.
+        """
+        key = load_privatekey(FILETYPE_PEM, root_key_pem).to_cryptography_key()
+        request = self._certificate_request(key)
+        request = request[:-1] + bytes([request[-1] ^ 1])
+        (info,) = validate_certificate_requests(FILETYPE_ASN1, [request])
+        assert not info.signature_valid
+        assert info.subject == ((b"C", b"US"), (b"CN", b"example"))
+
+    def test_validate_certificate_requests_errors(self):
+        """
+        `validate_certificate_requests` returns `OpenSSL.crypto.Error` for a
+        buffer which is not a request and `ValueError` for a request with a
+        malformed subjectAltName, without affecting the other requests.
+        """
+        key = ec.generate_private_key(ec.SECP256R1())
+        malformed = self._certificate_request(
+            key,
+            extension=x509.UnrecognizedExtension(
+                x509.ExtensionOID.SUBJECT_ALTERNATIVE_NAME, b"\x04\x00"
+            ),
+        )
+        good = self._certificate_request(key, [x509.DNSName("example.com")])
+        results = validate_certificate_requests(
+            FILETYPE_ASN1, [b"junk", malformed, good], 2
+        )
+        assert isinstance(results[0], Error)
+        assert isinstance(results[1], ValueError)
+        assert results[2].dns_names == ("example.com",)
+
+    def test_validate_certificate_requests_invalid_type(self):
+        """
+        `validate_certificate_requests` raises `ValueError` for an unknown file
+        type.
+        """
+        with pytest.raises(ValueError):
+            validate_certificate_requests(
+                FILETYPE_TEXT, [cleartextCertificateRequestPEM]
+            )
+
+    @staticmethod
+    def _encrypted_keys(encoding):
+        """
+        Return three new EC keys and ``(buffer, passphrase)`` pairs for them
+        in *encoding*, the first two encrypted with different passphrases and
+        the last one unencrypted.
+        """
+        keys = [ec.generate_private_key(ec.SECP256R1()) for _ in range(3)]
+        pairs = []
+        for key, passphrase in zip(keys, [b"foo", b"bar", None]):
+            pairs.append(
+                (
+                    key.private_bytes(
+                        encoding,
+                        serialization.PrivateFormat.PKCS8,
+                        serialization.NoEncryption()
+                        if passphrase is None
+                        else serialization.BestAvailableEncryption(passphrase),
+                    ),
+                    passphrase,
+                )
+            )
+        return keys, pairs
+
+    @pytest.mark.parametrize("max_workers", [None, 1, 2])
+    @pytest.mark.parametrize(
+        "type, encoding",
+        [
+            (FILETYPE_PEM, serialization.Encoding.PEM),
+            (FILETYPE_ASN1, serialization.Encoding.DER),
+        ],
+    )
+    def test_load_privatekeys(self, type, encoding, max_workers):
+        """
+        `load_privatekeys` decrypts every key with its own passphrase and
+        returns the keys in input order, whatever the number of threads.
+        """
+        keys, pairs = self._encrypted_keys(encoding)
+        loaded = load_privatekeys(type, pairs * 3, max_workers)
+        assert [
+            pkey.to_cryptography_key().private_numbers() for pkey in loaded
+        ] == [key.private_numbers() for key in keys] * 3
+
+    def test_load_privatekeys_traditional(self):
+        """
+        `load_privatekeys` decrypts keys in the traditional PEM format.
+        """
+        (pkey,) = load_privatekeys(
+            FILETYPE_PEM,
+            [(encryptedPrivateKeyPEM, encryptedPrivateKeyPEMPassphrase)],
+        )
+        assert dump_privatekey(FILETYPE_PEM, pkey) == dump_privatekey(
+            FILETYPE_PEM,
+            load_privatekey(
+                FILETYPE_PEM,
+                encryptedPrivateKeyPEM,
+                encryptedPrivateKeyPEMPassphrase,
+            ),
+        )
+
+    @pytest.mark.parametrize(
+        "format",
+        [
+            serialization.PrivateFormat.PKCS8,
+            serialization.PrivateFormat.TraditionalOpenSSL,
+        ],
+    )
+    def test_load_privatekeys_unencrypted_der(self, format):
+        """
+        `load_privatekeys` loads an unencrypted DER key even if it is given a
+        passphrase.
+        """
+        key = ec.generate_private_key(ec.SECP256R1())
+        der = key.private_bytes(
+            serialization.Encoding.DER, format, serialization.NoEncryption()
+        )
+        (pkey,) = load_privatekeys(FILETYPE_ASN1, [(der, b"foo")])
+        assert (
+            pkey.to_cryptography_key().private_numbers()
+            == key.private_numbers()
+        )
+        assert _lib.ERR_peek_error() == 0
+
+    @pytest.mark.parametrize(
+        "type, encoding",
+        [
+            (FILETYPE_PEM, serialization.Encoding.PEM),
+            (FILETYPE_ASN1, serialization.Encoding.DER),
+        ],
+    )
+    @pytest.mark.parametrize("passphrase", [b"quack", None])
+    def test_load_privatekeys_wrong_passphrase(
+        self, type, encoding, passphrase
+    ):
+        """
+        `load_privatekeys` raises `OpenSSL.crypto.Error` if a passphrase is
+        wrong or missing, without prompting for one.
+        """
+        _, pairs = self._encrypted_keys(encoding)
+        pairs[1] = (pairs[1][0], passphrase)
+        with pytest.raises(Error):
+            load_privatekeys(type, pairs, 2)
+
+    def test_load_privatekeys_invalid(self):
+        """
+        `load_privatekeys` raises `ValueError` for an unknown file type or a
+        passphrase containing a NUL byte, and `TypeError` for a passphrase
+        which is not a byte string.
+        """
+        pair = (encryptedPrivateKeyPEM, encryptedPrivateKeyPEMPassphrase)
+        with pytest.raises(ValueError):
+            load_privatekeys(FILETYPE_TEXT, [pair])
+        with pytest.raises(ValueError):
+            load_privatekeys(FILETYPE_PEM, [(encryptedPrivateKeyPEM, b"a\0")])
+        with pytest.raises(TypeError):
+            load_privatekeys(FILETYPE_PEM, [(encryptedPrivateKeyPEM, "foo")])
+
     def test_dump_privatekey_pem(self):
         """
         `dump_privatekey` writes a PEM
@@ -3136,6 +3983,66 @@ class TestCRL:
         assert revs[0].get_rev_date() == now
         assert revs[1].get_rev_date() == now
 
+    def test_add_revocations(self):
+        """
+        `CRL.add_revocations` adds a revocation for each tuple of serial
+        number, date and reason code.
+        """
+        crl = CRL()
+        count = crl.add_revocations(
+            [
+                (0x3AB, 1457575305, None),
+                (2**80, datetime(2060, 1, 1), 1),
+                (1, datetime(2016, 3, 10, 2, 1, 45, tzinfo=timezone.utc), 4),
+            ]
+        )
+        assert count == 3
+        revs = crl.get_revoked()
+        assert [r.get_serial() for r in revs] == [
+            b"03AB",
+            b"0100000000000000000000",
+            b"01",
+        ]
+        assert [r.get_rev_date() for r in revs] == [
+            b"20160310020145Z",
+            b"20600101000000Z",
+            b"20160310020145Z",
+        ]
+        assert [r.get_reason() for r in revs] == [
+            None,
+            b"Key Compromise",
+            b"Superseded",
+        ]
+
+        crl.add_revocations((serial, 0, None) for serial in range(1, 11))
+        assert len(crl.get_revoked()) == 13
+
+    def test_add_revocations_serial_sizes(self):
+        """
+        `CRL.add_revocations` keeps serial numbers around the sizes of C
+        integer types intact.
+        """
+        serials = [
+            2**bits + delta for bits in [31, 32, 63, 64] for delta in [-1, 0]
+        ]
+        crl = CRL()
+        crl.add_revocations((serial, 0, None) for serial in serials)
+        assert [int(r.get_serial(), 16) for r in crl.get_revoked()] == serials
+
+    @pytest.mark.parametrize(
+        "revocation", [(-1, 0, None), (0, 0, None), (1, 0, 7), (1, 0, 11)]
+    )
+    def test_add_revocations_invalid(self, revocation):
+        """
+        `CRL.add_revocations` raises `ValueError` for a serial number which
+        is not positive or an unknown reason code, and adds none of the
+        revocations.
+        """
+        crl = CRL()
+        with pytest.raises(ValueError):
+            crl.add_revocations([(1, 0, None), revocation])
+        assert crl.get_revoked() is None
+
     def test_load_crl(self):
         """
         Load a known CRL and inspect its revocations.  Both EM and DER formats
@@ -3338,6 +4245,211 @@ class TestCRL:
         crypto_crl = crl.to_cryptography()
         assert isinstance(crypto_crl, x509.CertificateRevocationList)
 
+    def test_pickle(self):
+        """
+        `CRL` round-trips through `pickle` without emitting deprecation
+        warnings.
+        """
+        crl = load_crl(FILETYPE_PEM, crlData)
+        with warnings.catch_warnings():
+            warnings.simplefilter("error")
+            copy = pickle.loads(pickle.dumps(crl))
+        assert dump_crl(FILETYPE_ASN1, copy) == dump_crl(FILETYPE_ASN1, crl)
+
+
+class TestWriteCRL:
+    """
+    Tests for `OpenSSL.crypto.write_crl`.
+    """
+
+    root_cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+    root_key = load_privatekey(FILETYPE_PEM, root_key_pem)
+    intermediate_cert = load_certificate(FILETYPE_PEM, intermediate_cert_pem)
+
+    def _write(self, revocations, cert=None, key=None, **kwargs):
+        out = io.BytesIO()
+        written = write_crl(
+            out,
+            cert or self.root_cert,
+            key or self.root_key,
+            revocations,
+            datetime(2024, 1, 1),
+            datetime(2024, 1, 8),
+            **kwargs,
+        )
+        assert written == len(out.getvalue())
+        crl = x509.load_der_x509_crl(out.getvalue())
+        assert crl.is_signature_valid(
+            (cert or self.root_cert).to_cryptography().public_key()
+        )
+        return crl
+
+    def test_entries(self):
+        """
+        `write_crl` writes a signed CRL with an entry for every revocation,
+        taking dates as timestamps or datetimes.
+        """
+        when = datetime(2023, 6, 1, 12, tzinfo=timezone.utc)
+        crl = self._write(
+            [
+                (1, int(when.timestamp()), None),
+                (2**100, when, 1),
+                (3, datetime(2060, 1, 1), 10),
+            ]
+        )
+        assert crl.issuer == self.root_cert.to_cryptography().subject
+        assert crl.last_update == datetime(2024, 1, 1)
+        assert crl.next_update == datetime(2024, 1, 8)
+        assert [r.serial_number for r in crl] == [1, 2**100, 3]
+        assert [r.revocation_date for r in crl] == [
+            datetime(2023, 6, 1, 12),
+            datetime(2023, 6, 1, 12),
+            datetime(2060, 1, 1),
+        ]
+        assert len(crl[0].extensions) == 0
+        assert (
+            crl[1]
+            .extensions.get_extension_for_class(x509.CRLReason)
+            .value.reason
+            == x509.ReasonFlags.key_compromise
+        )
+        assert (
+            crl[2]
+            .extensions.get_extension_for_class(x509.CRLReason)
+            .value.reason
+            == x509.ReasonFlags.aa_compromise
+        )
+        key_id = crl.extensions.get_extension_for_class(
+            x509.AuthorityKeyIdentifier
+        ).value.key_identifier
+        assert (
+            key_id
+            == self.root_cert.to_cryptography()
+            .extensions.get_extension_for_class(x509.SubjectKeyIdentifier)
+            .value.digest
+        )
+
+    def test_alternating_dates(self):
+        """
+        `write_crl` encodes the date of each revocation when dates alternate.
+        """
+        dates = [datetime(2023, 6, 1), datetime(2023, 6, 2)] * 3
+        crl = self._write(
+            (serial, date, None) for serial, date in enumerate(dates, 1)
+        )
+        assert [r.revocation_date for r in crl] == dates
+
+    def test_many_entries(self):
+        """
+        `write_crl` consumes an iterator of more entries than it encodes at
+        once.
+        """
+        crl = self._write((serial, 0, None) for serial in range(1, 10001))
+        assert len(crl) == 10000
+        assert crl.get_revoked_certificate_by_serial_number(9999) is not None
+
+    def test_empty(self):
+        """
+        A CRL without revocations has no revokedCertificates.
+        """
+        assert len(self._write([])) == 0
+
+    def test_delta(self):
+        """
+        `write_crl` writes the CRL number and, for a delta CRL, the number of
+        the complete CRL it is based on.
+        """
+        crl = self._write([], crl_number=7)
+        extension = crl.extensions.get_extension_for_class(x509.CRLNumber)
+        assert extension.value.crl_number == 7
+        with pytest.raises(x509.ExtensionNotFound):
+            crl.extensions.get_extension_for_class(x509.DeltaCRLIndicator)
+
+        crl = self._write([], crl_number=8, delta_crl_base=7)
+        extension = crl.extensions.get_extension_for_class(
+            x509.DeltaCRLIndicator
+        )
+        assert extension.critical
+        assert extension.value.crl_number == 7
+
+    @pytest.mark.parametrize("digest", ["sha256", "sha384", "sha512"])
+    def test_ec(self, digest):
+        """
+        `write_crl` signs with EC keys.
+        """
+        key = PKey.from_cryptography_key(
+            ec.generate_private_key(ec.SECP384R1())
+        )
+        cert = X509()
+        cert.get_subject().CN = "EC CRL issuer"
+        cert.set_issuer(cert.get_subject())
+        cert.gmtime_adj_notBefore(0)
+        cert.gmtime_adj_notAfter(3600)
+        cert.set_pubkey(key)
+        cert.sign(key, "sha256")
+        crl = self._write([(1, 0, 0)], cert, key, digest=digest)
+        assert crl.signature_hash_algorithm.name == digest
+
+    def test_revokes(self):
+        """
+        OpenSSL rejects certificates in a CRL written by `write_crl`.
+        """
+        serial = self.intermediate_cert.get_serial_number()
+        crl = self._write([(serial, 0, None)])
+        store = X509Store()
+        store.add_cert(self.root_cert)
+        store.add_crl(crl)
+        store.set_flags(X509StoreFlags.CRL_CHECK)
+        store.set_time(datetime(2024, 1, 2))
+        with pytest.raises(X509StoreContextError) as err:
+            X509StoreContext(
+                store, self.intermediate_cert
+            ).verify_certificate()
+        assert str(err.value) == "certificate revoked"
+
+    @pytest.mark.parametrize(
+        "revocations, kwargs",
+        [
+            ([(1, 0, 7)], {}),
+            ([(1, 0, 11)], {}),
+            ([(0, 0, None)], {}),
+            ([(-128, 0, None)], {}),
+            ([], {"crl_number": -1}),
+            ([], {"crl_number": 2, "delta_crl_base": -1}),
+            ([], {"delta_crl_base": 1}),
+            ([], {"digest": "md5"}),
+        ],
+    )
+    def test_invalid(self, revocations, kwargs):
+        """
+        `write_crl` raises `ValueError` for an unknown reason, a serial
+        number which is not positive, a negative CRL number, a delta CRL
+        without a CRL number, or an unsupported digest.
+        """
+        with pytest.raises(ValueError):
+            write_crl(
+                io.BytesIO(),
+                self.root_cert,
+                self.root_key,
+                revocations,
+                0,
+                0,
+                **kwargs,
+            )
+
+    def test_invalid_key(self):
+        """
+        `write_crl` raises `ValueError` for a key it cannot sign a streamed
+        CRL with, and `TypeError` for arguments of the wrong type.
+        """
+        key = PKey.from_cryptography_key(ed25519.Ed25519PrivateKey.generate())
+        with pytest.raises(ValueError):
+            write_crl(io.BytesIO(), self.root_cert, key, [], 0, 0)
+        with pytest.raises(TypeError):
+            write_crl(io.BytesIO(), None, self.root_key, [], 0, 0)
+        with pytest.raises(TypeError):
+            write_crl(io.BytesIO(), self.root_cert, None, [], 0, 0)
+
 
 class TestX509StoreContext:
     """
@@ -3373,6 +4485,168 @@ class TestX509StoreContext:
         assert store_ctx.verify_certificate() is None
         assert store_ctx.verify_certificate() is None
 
+    def test_verify_certificates(self):
+        """
+        `verify_certificates` returns ``None`` for each certificate that
+        verifies and the `X509StoreContextError` for each one that does not,
+        in input order.
+        """
+        store = X509Store()
+        store.add_cert(self.root_cert)
+        certs = [self.intermediate_server_cert, self.intermediate_cert] * 4
+        results = verify_certificates(store, certs, max_workers=3)
+        assert results[1::2] == [None] * 4
+        for error in results[::2]:
+            assert isinstance(error, X509StoreContextError)
+            assert error.certificate.get_subject().CN == "intermediate-service"
+
+        results = verify_certificates(
+            store, certs, chain=[self.intermediate_cert], max_workers=3
+        )
+        assert results == [None] * 8
+
+    @staticmethod
+    def _issue(subject, key, issuer, issuer_key, ca, subject_key_id=True):
+        """
+        Return a certificate for *key* issued by *issuer_key*, with an
+        authority key identifier and, if *subject_key_id* is true, a subject
+        key identifier.
+        """
+        now = datetime.now(timezone.utc)
+        builder = (
+            x509.CertificateBuilder()
+            .subject_name(x509.Name.from_rfc4514_string(subject))
+            .issuer_name(x509.Name.from_rfc4514_string(issuer))
+            .public_key(key.public_key())
+            .serial_number(x509.random_serial_number())
+            .not_valid_before(now - timedelta(days=1))
+            .not_valid_after(now + timedelta(days=1))
+            .add_extension(
+                x509.BasicConstraints(ca=ca, path_length=None), True
+            )
+            .add_extension(
+                x509.AuthorityKeyIdentifier.from_issuer_public_key(
+                    issuer_key.public_key()
+                ),
+                False,
+            )
+        )
+        if subject_key_id:
+            builder = builder.add_extension(
+                x509.SubjectKeyIdentifier.from_public_key(key.public_key()),
+                False,
+            )
+        return X509.from_cryptography(
+            builder.sign(issuer_key, hashes.SHA256())
+        )
+
+    @classmethod
+    def _key_id_chain(cls):
+        """
+        Return a root, two intermediates with the same subject but different
+        keys, and a leaf issued by the second intermediate.  All of them carry
+        key identifiers.
+        """
+        issue = cls._issue
+        keys = [ec.generate_private_key(ec.SECP256R1()) for _ in range(4)]
+        root = issue("CN=pool root", keys[0], "CN=pool root", keys[0], True)
+        first = issue("CN=pool ca", keys[1], "CN=pool root", keys[0], True)
+        second = issue("CN=pool ca", keys[2], "CN=pool root", keys[0], True)
+        leaf = issue("CN=pool leaf", keys[3], "CN=pool ca", keys[2], False)
+        return root, first, second, leaf
+
+    def test_intermediate_pool(self):
+        """
+        An `X509IntermediatePool` passed as the chain supplies only the
+        intermediates on the path of the verified certificate.
+        """
+        unrelated = [
+            load_certificate(FILETYPE_PEM, pem)
+            for pem in [server_cert_pem, client_cert_pem]
+        ]
+        pool = X509IntermediatePool([*unrelated, self.intermediate_cert])
+        assert len(pool) == 3
+        assert pool._find_path(self.intermediate_server_cert) == [
+            self.intermediate_cert
+        ]
+
+        store = X509Store()
+        store.add_cert(self.root_cert)
+        store_ctx = X509StoreContext(
+            store, self.intermediate_server_cert, chain=pool
+        )
+        assert store_ctx.verify_certificate() is None
+        assert (
+            verify_certificates(
+                store, [self.intermediate_server_cert] * 4, pool, 2
+            )
+            == [None] * 4
+        )
+
+    def test_intermediate_pool_missing(self):
+        """
+        Verification fails if the pool lacks an intermediate.
+        """
+        store = X509Store()
+        store.add_cert(self.root_cert)
+        pool = X509IntermediatePool()
+        pool.add_certificate(self.root_cert)
+        store_ctx = X509StoreContext(
+            store, self.intermediate_server_cert, chain=pool
+        )
+        with pytest.raises(X509StoreContextError):
+            store_ctx.verify_certificate()
+
+    def test_intermediate_pool_key_identifier(self):
+        """
+        Where several intermediates share a subject name, the authority key
+        identifier selects the right one.
+        """
+        root, first, second, leaf = self._key_id_chain()
+        pool = X509IntermediatePool([first, second])
+        assert pool._find_path(leaf) == [second]
+
+        store = X509Store()
+        store.add_cert(root)
+        chain = X509StoreContext(store, leaf, pool).get_verified_chain()
+        assert [cert.digest("sha256") for cert in chain] == [
+            cert.digest("sha256") for cert in [leaf, second, root]
+        ]
+
+    def test_intermediate_pool_key_identifier_other_subject(self):
+        """
+        If the certificates matching the authority key identifier have a
+        different subject than the issuer name, the issuer is looked up by
+        name instead.
+        """
+        keys = [ec.generate_private_key(ec.SECP256R1()) for _ in range(3)]
+        root = self._issue(
+            "CN=pool root", keys[0], "CN=pool root", keys[0], True
+        )
+        renamed = self._issue(
+            "CN=pool renamed", keys[1], "CN=pool root", keys[0], True
+        )
+        issuer = self._issue(
+            "CN=pool ca", keys[1], "CN=pool root", keys[0], True, False
+        )
+        leaf = self._issue(
+            "CN=pool leaf", keys[2], "CN=pool ca", keys[1], False
+        )
+        pool = X509IntermediatePool([renamed, issuer])
+        assert pool._find_path(leaf) == [issuer]
+
+        store = X509Store()
+        store.add_cert(root)
+        assert X509StoreContext(store, leaf, pool).verify_certificate() is None
+
+    def test_intermediate_pool_invalid(self):
+        """
+        `X509IntermediatePool.add_certificate` raises `TypeError` for anything
+        but an `X509`.
+        """
+        with pytest.raises(TypeError):
+            X509IntermediatePool([b"junk"])
+
     @pytest.mark.parametrize(
         "root_cert, chain, verified_cert",
         [
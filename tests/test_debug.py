@@ -1,5 +1,18 @@
+import json
+
 from OpenSSL import version
-from OpenSSL.debug import _env_info
+from OpenSSL.debug import (
+    _BENCHMARKS,
+    _SPEED_CIPHERS,
+    _SPEED_CSR_COUNT,
+    _SPEED_RECORD_SIZES,
+    _SPEED_THREADS,
+    _SPEED_TRUST_STORE_SIZE,
+    _cpu_info,
+    _env_info,
+    _main,
+    _speed,
+)
 
 
 def test_debug_info():
@@ -8,3 +21,159 @@ def test_debug_info():
     """
     # Just check a sample we control.
     assert version.__version__ in _env_info
+
+
+def test_main(capsys):
+    """
+    Without arguments, the debug info is printed.
+    """
+    _main([])
+    assert version.__version__ in capsys.readouterr().out
+
+
+def test_cpu_info():
+    """
+    The CPU info contains the raw OpenSSL string and, if OpenSSL reports a
+    capability vector this module knows, the names of the enabled flags.
+    """
+    info = _cpu_info()
+    assert isinstance(info["raw"], str)
+    if info["flags"] is not None:
+        assert all(isinstance(flag, str) for flag in info["flags"])
+
+
+def test_speed():
+    """
+    The speed test reports a positive throughput for every cipher and record
+    size, and positive handshake rates.
+    """
+    result = _speed(duration=0.001)
+    assert result["cpu"] == _cpu_info()
+    assert [(r["cipher"], r["record_size"]) for r in result["aead"]] == [
+        (cipher.decode("ascii"), size)
+        for cipher in _SPEED_CIPHERS
+        for size in _SPEED_RECORD_SIZES
+    ]
+    assert all(r["bytes_per_second"] > 0 for r in result["aead"])
+    assert [
+        (r["key"], r["message_recorder"]) for r in result["handshakes"]
+    ] == [
+        ("rsa2048", False),
+        ("ecdsa-p256", False),
+        ("ecdsa-p256", True),
+    ]
+    assert all(r["handshakes_per_second"] > 0 for r in result["handshakes"])
+
+
+def test_trust_store_speed():
+    """
+    The trust store benchmark compares an eager and a lazy store.
+    """
+    result = _BENCHMARKS["trust-store"](0.001)
+    assert [r["store"] for r in result] == ["X509Store", "X509LazyStore"]
+    for r in result:
+        assert r["certificates"] == _SPEED_TRUST_STORE_SIZE
+        assert r["load_seconds"] > 0
+        assert r["first_verification_seconds"] > 0
+        assert r["verifications_per_second"] > 0
+
+
+def test_verification_scaling():
+    """
+    The verification scaling benchmark covers every thread count with a
+    shared and a replicated store.
+    """
+    result = _BENCHMARKS["verification-scaling"](0.001)
+    assert [(r["replicated"], r["threads"]) for r in result] == [
+        (replicated, threads)
+        for replicated in [False, True]
+        for threads in _SPEED_THREADS
+    ]
+    assert all(r["verifications_per_second"] > 0 for r in result)
+
+
+def test_crl_speed():
+    """
+    The CRL benchmark writes entries for about as long as it is given.
+    """
+    short = _BENCHMARKS["crl"](0.001)
+    assert short["entries"] == 4096
+    assert short["entries_per_second"] > 0
+    longer = _BENCHMARKS["crl"](0.2)
+    assert longer["entries"] > short["entries"]
+    assert longer["bytes"] > short["bytes"]
+    assert longer["seconds"] >= 0.2
+
+
+def test_csr_speed():
+    """
+    The CSR benchmark compares X509Req with
+    `validate_certificate_requests`.
+    """
+    result = _BENCHMARKS["csr"](0.001)
+    assert [r["method"] for r in result] == [
+        "X509Req",
+        "validate_certificate_requests",
+    ]
+    for r in result:
+        assert r["requests"] == _SPEED_CSR_COUNT
+        assert r["requests_per_second"] > 0
+
+
+def test_private_key_speed():
+    """
+    The private key benchmark compares `load_privatekey` with
+    `load_privatekeys` at every thread count.
+    """
+    result = _BENCHMARKS["private-keys"](0.001)
+    assert [(r["method"], r["threads"]) for r in result] == [
+        ("load_privatekey", 1)
+    ] + [("load_privatekeys", threads) for threads in _SPEED_THREADS]
+    assert all(r["keys_per_second"] > 0 for r in result)
+
+
+def test_main_speed(capsys):
+    """
+    ``--speed`` prints the speed test results as JSON.
+    """
+    _main(["--speed", "--duration", "0.001"])
+    result = json.loads(capsys.readouterr().out)
+    assert set(result) == {"openssl", "cpu", "aead", "handshakes"}
+
+
+def test_main_benchmark(capsys, monkeypatch):
+    """
+    ``--benchmark`` runs the named benchmarks with the given duration and
+    prints their results as JSON, after the speed test results if
+    ``--speed`` is given too.
+    """
+    durations = []
+
+    def fake(name):
+        def benchmark(duration):
+            durations.append(duration)
+            return name
+
+        return benchmark
+
+    for name in _BENCHMARKS:
+        monkeypatch.setitem(_BENCHMARKS, name, fake(name))
+    _main(["--benchmark", "crl", "--benchmark", "csr", "--duration", "0.25"])
+    result = json.loads(capsys.readouterr().out)
+    assert result == {
+        "openssl": result["openssl"],
+        "cpu": _cpu_info(),
+        "crl": "crl",
+        "csr": "csr",
+    }
+    assert durations == [0.25, 0.25]
+
+    _main(["--speed", "--benchmark", "trust-store", "--duration", "0.001"])
+    result = json.loads(capsys.readouterr().out)
+    assert set(result) == {
+        "openssl",
+        "cpu",
+        "aead",
+        "handshakes",
+        "trust_store",
+    }
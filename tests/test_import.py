@@ -0,0 +1,82 @@
+"""
+Tests for what importing :py:mod:`OpenSSL` loads.
+"""
+
+import os
+import subprocess
+import sys
+
+import pytest
+
+
+def _imported_modules(statement):
+    """
+    Run *statement* in a fresh interpreter and return the names of the
+    modules it left in ``sys.modules``.
+    """
+    env = dict(os.environ)
+    env["PYTHONPATH"] = os.pathsep.join(sys.path)
+    result = subprocess.run(
+        [
+            sys.executable,
+            "-c",
+            statement + "\nimport sys\nprint('\\n'.join(sys.modules))",
+        ],
+        env=env,
+        stdout=subprocess.PIPE,
+        check=True,
+    )
+    return set(result.stdout.decode("utf-8").splitlines())
+
+
+class TestImport:
+    """
+    Tests for what importing `OpenSSL` loads.
+    """
+
+    def test_package_is_lazy(self):
+        """
+        Importing `OpenSSL` does not import `OpenSSL.SSL` or `OpenSSL.crypto`
+        until they are used.
+        """
+        modules = _imported_modules("import OpenSSL")
+        assert "OpenSSL" in modules
+        assert "OpenSSL.SSL" not in modules
+        assert "OpenSSL.crypto" not in modules
+
+    @pytest.mark.parametrize(
+        "statement, unwanted",
+        [
+            ("import OpenSSL.crypto", ["OpenSSL.SSL", "cryptography.x509"]),
+            ("import OpenSSL.SSL", ["cryptography.x509"]),
+        ],
+    )
+    def test_no_heavy_dependencies(self, statement, unwanted):
+        """
+        Importing a submodule does not load modules it does not need until
+        they are used.
+        """
+        modules = _imported_modules(statement)
+        for name in unwanted:
+            assert name not in modules
+
+    def test_submodule_attribute(self):
+        """
+        Using a submodule as an attribute of `OpenSSL` imports it.
+        """
+        modules = _imported_modules("import OpenSSL\nOpenSSL.crypto")
+        assert "OpenSSL.crypto" in modules
+        assert "OpenSSL.SSL" not in modules
+
+    def test_dir(self):
+        """
+        ``dir(OpenSSL)`` lists the lazily imported submodules along with the
+        module's own attributes.
+        """
+        import OpenSSL
+
+        names = dir(OpenSSL)
+        assert names == sorted(names)
+        assert {"SSL", "crypto", "__version__", "__name__", "__doc__"} <= set(
+            names
+        )
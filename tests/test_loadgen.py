@@ -0,0 +1,196 @@
+"""
+Unit tests for :py:mod:`OpenSSL.loadgen`.
+"""
+
+import json
+import socket
+import time
+
+import pytest
+
+from OpenSSL._util import ffi as _ffi
+from OpenSSL.loadgen import (
+    _KEY_TYPES,
+    _Config,
+    _contexts,
+    _main,
+    _Pair,
+    _percentile,
+    _Stats,
+    _worker,
+)
+
+from .test_crypto import server_cert_pem, server_key_pem
+
+
+def _config(**kwargs):
+    defaults = dict(
+        transport="memory",
+        protocol="1.3",
+        cipher=None,
+        key_type="ecdsa-p256",
+        cert_file=None,
+        key_file=None,
+        resumption=False,
+        payload_size=100,
+        requests=1,
+        duration=0.01,
+    )
+    defaults.update(kwargs)
+    return _Config(**defaults)
+
+
+def _run_json(capsys, args):
+    _main(["--json", "--duration", "0.01", *args])
+    return json.loads(capsys.readouterr().out)
+
+
+class TestLoadgen:
+    """
+    Tests for the ``python -m OpenSSL.loadgen`` load generator.
+    """
+
+    def test_percentile(self):
+        """
+        `_percentile` uses the nearest-rank method and returns ``None`` for
+        no values.
+        """
+        values = [float(v) for v in range(100, 0, -1)]
+        assert _percentile(values, 0.5) == 50.0
+        assert _percentile(values, 0.99) == 99.0
+        assert _percentile([3.0], 0.99) == 3.0
+        assert _percentile([], 0.5) is None
+
+    @pytest.mark.parametrize("transport", ["memory", "socket"])
+    def test_json(self, capsys, transport):
+        """
+        With ``--json`` one result is printed per concurrency level.
+        """
+        results = _run_json(
+            capsys, ["--transport", transport, "--concurrency", "1,2"]
+        )
+        assert [r["concurrency"] for r in results] == [1, 2]
+        for result in results:
+            assert result["handshakes"] >= result["concurrency"]
+            assert result["handshakes_per_second"] > 0
+            assert result["megabytes_per_second"] > 0
+            assert 0 < result["handshake_p50_ms"] <= result["handshake_p99_ms"]
+            assert 0 < result["request_p50_ms"] <= result["request_p99_ms"]
+
+    def test_socket_transport(self):
+        """
+        The ``socket`` transport connects each pair over TCP on 127.0.0.1.
+        """
+        config = _config(transport="socket")
+        pair = _Pair(config, *_contexts(config))
+        try:
+            assert len(pair._sockets) == 2
+            for sock in pair._sockets:
+                assert sock.family == socket.AF_INET
+                assert sock.type == socket.SOCK_STREAM
+                assert sock.getsockname()[0] == "127.0.0.1"
+            pair.handshake()
+            pair.transfer(pair.client, pair.server, b"x" * 100000)
+        finally:
+            pair.close()
+
+    def test_table(self, capsys):
+        """
+        Without ``--json`` a table is printed.
+        """
+        _main(["--duration", "0.01", "--requests", "0"])
+        header, row = capsys.readouterr().out.splitlines()
+        assert header.split()[:2] == ["concurrency", "handshakes/s"]
+        # No requests, so no request latencies.
+        assert row.split()[0] == "1"
+        assert row.split()[-2:] == ["-", "-"]
+
+    @pytest.mark.parametrize(
+        "protocol, cipher",
+        [
+            ("1.2", "ECDHE-ECDSA-AES128-GCM-SHA256"),
+            ("1.3", "TLS_CHACHA20_POLY1305_SHA256"),
+        ],
+    )
+    def test_cipher(self, capsys, protocol, cipher):
+        """
+        ``--cipher`` sets the cipher list or, for TLS 1.3, the cipher suites.
+        """
+        (result,) = _run_json(
+            capsys, ["--protocol", protocol, "--cipher", cipher]
+        )
+        assert result["handshakes"] > 0
+
+    def test_cipher_invalid(self):
+        """
+        An unknown TLS 1.3 cipher suite is rejected.
+        """
+        with pytest.raises(ValueError):
+            _contexts(_config(cipher="TLS_NONEXISTENT"))
+
+    @pytest.mark.parametrize("key_type", _KEY_TYPES)
+    def test_key_types(self, key_type):
+        """
+        A certificate can be generated for every key type.
+        """
+        server_context, client_context = _contexts(_config(key_type=key_type))
+        stats = _Stats()
+        _worker(
+            _config(),
+            server_context,
+            client_context,
+            time.perf_counter(),
+            stats,
+        )
+        assert len(stats.handshake_latencies) == 1
+
+    def test_cert_file(self, tmpfile, capsys):
+        """
+        ``--cert`` and ``--key`` load the server credentials from files.
+        """
+        cert_file = tmpfile + b".cert"
+        key_file = tmpfile + b".key"
+        with open(cert_file, "wb") as f:
+            f.write(server_cert_pem)
+        with open(key_file, "wb") as f:
+            f.write(server_key_pem)
+
+        (result,) = _run_json(
+            capsys,
+            ["--cert", cert_file.decode(), "--key", key_file.decode()],
+        )
+        assert result["handshakes"] > 0
+
+    def test_key_without_cert(self):
+        """
+        ``--key`` without ``--cert`` is an error.
+        """
+        with pytest.raises(SystemExit):
+            _main(["--key", "key.pem"])
+
+    @pytest.mark.parametrize("protocol", ["1.2", "1.3"])
+    @pytest.mark.parametrize("transport", ["memory", "socket"])
+    def test_resumption(self, protocol, transport):
+        """
+        With resumption every handshake after a worker's first resumes the
+        previous session, so the server sends its certificate only once.
+        """
+        config = _config(
+            protocol=protocol, transport=transport, resumption=True
+        )
+        server_context, client_context = _contexts(config)
+        certificates = []
+
+        def observer(write_p, version, content_type, buf, length, ssl):
+            # Certificate is handshake message type 11.
+            if write_p and content_type == 22:
+                if _ffi.buffer(buf, length)[:1] == b"\x0b":
+                    certificates.append(ssl)
+
+        server_context._add_message_observer(observer)
+        stats = _Stats()
+        deadline = time.perf_counter() + 0.05
+        _worker(config, server_context, client_context, deadline, stats)
+
+        assert len(stats.handshake_latencies) > 1
+        assert len(certificates) == 1
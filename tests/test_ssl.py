@@ -45,13 +45,18 @@ from OpenSSL import SSL
 from OpenSSL._util import ffi as _ffi
 from OpenSSL._util import lib as _lib
 from OpenSSL.crypto import (
+    FILETYPE_ASN1,
     FILETYPE_PEM,
+    FILETYPE_TEXT,
     TYPE_RSA,
     X509,
     PKey,
     X509Store,
+    X509StoreContext,
+    X509StoreContextError,
     dump_certificate,
     dump_privatekey,
+    get_elliptic_curve,
     get_elliptic_curves,
     load_certificate,
     load_privatekey,
@@ -110,10 +115,13 @@ from OpenSSL.SSL import (
     VERIFY_NONE,
     VERIFY_PEER,
     Connection,
+    ConnectionInfo,
     Context,
     Error,
     OP_NO_SSLv2,
     OP_NO_SSLv3,
+    Provider,
+    RecordedMessage,
     Session,
     SSLeay_version,
     SSLv23_METHOD,
@@ -123,8 +131,10 @@ from OpenSSL.SSL import (
     TLSv1_METHOD,
     WantReadError,
     WantWriteError,
+    X509VerificationCodes,
     ZeroReturnError,
     _make_requires,
+    load_provider,
 )
 
 try:
@@ -145,6 +155,9 @@ except ImportError:
 from .test_crypto import (
     client_cert_pem,
     client_key_pem,
+    crlData,
+    encryptedPrivateKeyPEM,
+    encryptedPrivateKeyPEMPassphrase,
     root_cert_pem,
     root_key_pem,
     server_cert_pem,
@@ -481,6 +494,26 @@ def context():
     return Context(SSLv23_METHOD)
 
 
+class _FakeKeyUpdateLib:
+    """
+    Stand in for the OpenSSL bindings, recording the update types passed to
+    ``SSL_key_update``.
+    """
+
+    SSL_KEY_UPDATE_NOT_REQUESTED = 0
+    SSL_KEY_UPDATE_REQUESTED = 1
+
+    def __init__(self):
+        self.calls = []
+
+    def __getattr__(self, name):
+        return getattr(_lib, name)
+
+    def SSL_key_update(self, ssl, update_type):
+        self.calls.append(update_type)
+        return 1
+
+
 class TestContext:
     """
     Unit tests for `OpenSSL.SSL.Context`.
@@ -1594,6 +1627,216 @@ class TestContext:
         with pytest.raises(Error):
             context.use_certificate_chain_file(tmpfile)
 
+    def _chain_buffer_handshake(self, serverContext, cacert):
+        """
+        Connect a client which trusts the PEM buffer *cacert* and requires
+        verification to succeed to a server using *serverContext*, and return
+        the common names of the certificates the server sent.
+        """
+        clientContext = Context(SSLv23_METHOD)
+        clientContext.set_verify(
+            VERIFY_PEER | VERIFY_FAIL_IF_NO_PEER_CERT, verify_cb
+        )
+        clientContext.load_verify_buffer(cacert)
+
+        server = Connection(serverContext, None)
+        server.set_accept_state()
+        client = Connection(clientContext, None)
+        client.set_connect_state()
+        handshake_in_memory(client, server)
+        return [cert.get_subject().CN for cert in client.get_peer_cert_chain()]
+
+    def test_use_certificate_chain_buffer(self):
+        """
+        `Context.use_certificate_chain_buffer` uses the first certificate in
+        a PEM buffer as the certificate of the context and the others as its
+        chain.
+        """
+        [(_, cacert), (_, icert), (skey, scert)] = _create_certificate_chain()
+        serverContext = Context(SSLv23_METHOD)
+        serverContext.use_certificate_chain_buffer(
+            dump_certificate(FILETYPE_PEM, scert)
+            + dump_certificate(FILETYPE_PEM, icert)
+        )
+        serverContext.use_privatekey_buffer(
+            dump_privatekey(FILETYPE_ASN1, skey), FILETYPE_ASN1
+        )
+
+        assert self._chain_buffer_handshake(
+            serverContext, dump_certificate(FILETYPE_PEM, cacert)
+        ) == ["Server Certificate", "Intermediate Certificate"]
+
+    def test_use_certificate_chain_and_key_buffer(self):
+        """
+        `Context.use_certificate_chain_and_key_buffer` loads a certificate
+        chain and its private key from one PEM buffer, in any order.
+        """
+        [(_, cacert), (_, icert), (skey, scert)] = _create_certificate_chain()
+        serverContext = Context(SSLv23_METHOD)
+        serverContext.use_certificate_chain_and_key_buffer(
+            dump_certificate(FILETYPE_PEM, scert)
+            + dump_privatekey(FILETYPE_PEM, skey)
+            + dump_certificate(FILETYPE_PEM, icert)
+        )
+        serverContext.check_privatekey()
+
+        assert self._chain_buffer_handshake(
+            serverContext, dump_certificate(FILETYPE_PEM, cacert)
+        ) == ["Server Certificate", "Intermediate Certificate"]
+
+    def test_use_certificate_chain_and_key_buffer_encrypted(self):
+        """
+        `Context.use_certificate_chain_and_key_buffer` decrypts the private
+        key with the passphrase callback, and raises `OpenSSL.SSL.Error`
+        without prompting if there is none.
+        """
+        key = load_privatekey(
+            FILETYPE_PEM,
+            encryptedPrivateKeyPEM,
+            encryptedPrivateKeyPEMPassphrase,
+        )
+        cert = load_certificate(FILETYPE_PEM, root_cert_pem)
+        cert.set_pubkey(key)
+        cert.sign(key, "sha256")
+        buffer = dump_certificate(FILETYPE_PEM, cert) + encryptedPrivateKeyPEM
+
+        context = Context(SSLv23_METHOD)
+        with pytest.raises(Error):
+            context.use_certificate_chain_and_key_buffer(buffer)
+
+        context.set_passwd_cb(lambda *args: encryptedPrivateKeyPEMPassphrase)
+        context.use_certificate_chain_and_key_buffer(buffer)
+        context.check_privatekey()
+
+    def test_use_privatekey_buffer_encrypted_asn1(self):
+        """
+        `Context.use_privatekey_buffer` decrypts an encrypted PKCS #8 DER
+        private key with the passphrase callback.
+        """
+        key = load_privatekey(FILETYPE_PEM, root_key_pem)
+        buffer = key.to_cryptography_key().private_bytes(
+            serialization.Encoding.DER,
+            serialization.PrivateFormat.PKCS8,
+            serialization.BestAvailableEncryption(b"foobar"),
+        )
+        context = Context(SSLv23_METHOD)
+        context.use_certificate(load_certificate(FILETYPE_PEM, root_cert_pem))
+        with pytest.raises(Error):
+            context.use_privatekey_buffer(buffer, FILETYPE_ASN1)
+
+        context.set_passwd_cb(lambda *args: b"foobar")
+        context.use_privatekey_buffer(buffer, FILETYPE_ASN1)
+        context.check_privatekey()
+
+    def test_use_certificate_chain_buffer_twice(self):
+        """
+        The chain buffer methods of `Context` raise `ValueError` and leave
+        the context unchanged if it already has extra chain certificates,
+        rather than sending the old intermediates with the new chain.
+        """
+        [_, (_, icert), (skey, scert)] = _create_certificate_chain()
+        chain = dump_certificate(FILETYPE_PEM, scert) + dump_certificate(
+            FILETYPE_PEM, icert
+        )
+        context = Context(SSLv23_METHOD)
+        context.use_certificate_chain_and_key_buffer(
+            chain + dump_privatekey(FILETYPE_PEM, skey)
+        )
+        with pytest.raises(ValueError):
+            context.use_certificate_chain_buffer(chain)
+        with pytest.raises(ValueError):
+            context.use_certificate_chain_and_key_buffer(
+                client_cert_pem + client_key_pem
+            )
+        context.check_privatekey()
+        assert (
+            Connection(context, None).get_certificate().get_subject().CN
+            == "Server Certificate"
+        )
+
+        context = Context(SSLv23_METHOD)
+        context.add_extra_chain_cert(icert)
+        with pytest.raises(ValueError):
+            context.use_certificate_chain_buffer(chain)
+
+    @pytest.mark.parametrize(
+        "buffer",
+        [
+            b"",
+            root_key_pem,
+            server_cert_pem + root_cert_pem[:100] + root_key_pem,
+            server_cert_pem + root_key_pem,
+            server_cert_pem,
+        ],
+    )
+    def test_use_certificate_chain_and_key_buffer_invalid(self, buffer):
+        """
+        `Context.use_certificate_chain_and_key_buffer` raises
+        `OpenSSL.SSL.Error` and leaves the context unchanged if the buffer
+        has no certificate, a malformed certificate, no private key, or a
+        private key which does not match the certificate.
+        """
+        context = Context(SSLv23_METHOD)
+        context.use_certificate_chain_and_key_buffer(
+            client_cert_pem + client_key_pem
+        )
+        with pytest.raises(Error):
+            context.use_certificate_chain_and_key_buffer(buffer)
+        context.check_privatekey()
+        assert (
+            Connection(context, None).get_certificate().get_subject().CN
+            == "ugly client"
+        )
+
+    def test_buffer_wrong_args(self):
+        """
+        The buffer methods of `Context` raise `TypeError` if passed anything
+        but a byte string, and `use_privatekey_buffer` raises `ValueError`
+        for an unknown file type.
+        """
+        context = Context(SSLv23_METHOD)
+        for method in [
+            context.use_certificate_chain_buffer,
+            context.use_privatekey_buffer,
+            context.use_certificate_chain_and_key_buffer,
+            context.load_verify_buffer,
+        ]:
+            with pytest.raises(TypeError):
+                method(root_cert_pem.decode("ascii"))
+        with pytest.raises(ValueError):
+            context.use_privatekey_buffer(root_key_pem, FILETYPE_TEXT)
+
+    def test_load_verify_buffer(self):
+        """
+        `Context.load_verify_buffer` adds every certificate and CRL in a PEM
+        buffer to the trust store of the context.
+        """
+        context = Context(SSLv23_METHOD)
+        context.load_verify_buffer(crlData + root_cert_pem + client_cert_pem)
+        store = context.get_cert_store()
+        for pem in [server_cert_pem, client_cert_pem]:
+            X509StoreContext(
+                store, load_certificate(FILETYPE_PEM, pem)
+            ).verify_certificate()
+
+    @pytest.mark.parametrize(
+        "buffer", [b"", root_key_pem, root_cert_pem + crlData[:100]]
+    )
+    def test_load_verify_buffer_invalid(self, buffer):
+        """
+        `Context.load_verify_buffer` raises `OpenSSL.SSL.Error` and trusts
+        nothing new if the buffer has no certificate or CRL, or a malformed
+        one.
+        """
+        context = Context(SSLv23_METHOD)
+        with pytest.raises(Error):
+            context.load_verify_buffer(buffer)
+        with pytest.raises(X509StoreContextError):
+            X509StoreContext(
+                context.get_cert_store(),
+                load_certificate(FILETYPE_PEM, server_cert_pem),
+            ).verify_certificate()
+
     def test_set_verify_mode(self):
         """
         `Context.get_verify_mode` returns the verify mode flags previously
@@ -1687,6 +1930,253 @@ class TestContext:
             # exception.
             context.set_tmp_ecdh(curve)
 
+    @pytest.mark.parametrize(
+        "server_curve, expected", [(None, 0), ("prime256v1", 1)]
+    )
+    def test_hello_retry_request_count(self, server_curve, expected):
+        """
+        `Context.get_hello_retry_request_count` counts the HelloRetryRequests
+        sent by a server whose preferred group the client sent no key share
+        for, and received by that client.
+        """
+        server_context = Context(TLS_METHOD)
+        server_context.use_privatekey(
+            load_privatekey(FILETYPE_PEM, server_key_pem)
+        )
+        server_context.use_certificate(
+            load_certificate(FILETYPE_PEM, server_cert_pem)
+        )
+        server_context.set_min_proto_version(TLS1_3_VERSION)
+        if server_curve is not None:
+            server_context.set_tmp_ecdh(get_elliptic_curve(server_curve))
+        server_context.track_hello_retry_requests()
+        client_context = Context(TLS_METHOD)
+        client_context.track_hello_retry_requests()
+
+        def server_factory(sock):
+            server = Connection(server_context, sock)
+            server.set_accept_state()
+            return server
+
+        def client_factory(sock):
+            client = Connection(client_context, sock)
+            client.set_connect_state()
+            return client
+
+        loopback(server_factory, client_factory)
+        assert server_context.get_hello_retry_request_count() == expected
+        assert client_context.get_hello_retry_request_count() == expected
+
+    def test_hello_retry_request_count_untracked(self):
+        """
+        `Context.get_hello_retry_request_count` returns `None` unless
+        `Context.track_hello_retry_requests` was called.
+        """
+        context = Context(TLS_METHOD)
+        assert context.get_hello_retry_request_count() is None
+        context.track_hello_retry_requests()
+        context.track_hello_retry_requests()
+        assert context.get_hello_retry_request_count() == 0
+
+    def _recorded_connections(self, size, trust=True):
+        """
+        Return a server and client whose contexts record *size* messages,
+        after attempting a TLS 1.3 handshake in which the client verifies
+        the server certificate, trusting its CA only if *trust* is true.
+        """
+        server_context = Context(TLS_METHOD)
+        server_context.use_privatekey(
+            load_privatekey(FILETYPE_PEM, server_key_pem)
+        )
+        server_context.use_certificate(
+            load_certificate(FILETYPE_PEM, server_cert_pem)
+        )
+        server_context.set_min_proto_version(TLS1_3_VERSION)
+        server_context.set_message_recorder(size)
+        client_context = Context(TLS_METHOD)
+        client_context.set_verify(VERIFY_PEER)
+        if trust:
+            client_context.get_cert_store().add_cert(
+                load_certificate(FILETYPE_PEM, root_cert_pem)
+            )
+        client_context.set_message_recorder(size)
+
+        server = Connection(server_context, None)
+        server.set_accept_state()
+        client = Connection(client_context, None)
+        client.set_connect_state()
+        try:
+            handshake_in_memory(client, server)
+        except Error:
+            # Deliver the client's alert.
+            server.bio_write(client.bio_read(2**16))
+            with pytest.raises(Error):
+                server.do_handshake()
+        return server, client
+
+    def test_message_recorder(self):
+        """
+        `Connection.get_recorded_messages` returns the handshake messages a
+        connection sent and received, oldest first.
+        """
+        server, client = self._recorded_connections(32)
+        client_messages = client.get_recorded_messages()
+        server_messages = server.get_recorded_messages()
+
+        assert all(isinstance(m, RecordedMessage) for m in client_messages)
+        # ClientHello.
+        assert client_messages[0][:4] == (True, TLS1_3_VERSION, 22, 1)
+        assert server_messages[0] == client_messages[0]._replace(sent=False)
+        # ServerHello, then later the Finished messages.
+        assert (False, 22, 2) in [
+            (m.sent, m.content_type, m.message_type) for m in client_messages
+        ]
+        for messages in [client_messages, server_messages]:
+            finished = [m.sent for m in messages if m.message_type == 20]
+            assert sorted(finished) == [False, True]
+
+    def test_message_recorder_bounded(self):
+        """
+        `Connection.get_recorded_messages` returns at most as many messages
+        as were passed to `Context.set_message_recorder`, the latest ones.
+        """
+        _, unbounded = self._recorded_connections(100)
+        _, bounded = self._recorded_connections(3)
+        # Lengths can differ between handshakes, for example those of
+        # session tickets.
+        assert [m[:5] for m in bounded.get_recorded_messages()] == [
+            m[:5] for m in unbounded.get_recorded_messages()[-3:]
+        ]
+
+    def test_message_recorder_alert(self):
+        """
+        After a failed handshake, `Connection.get_recorded_messages` ends
+        with the fatal alert sent by one side and received by the other.
+        """
+        server, client = self._recorded_connections(32, trust=False)
+        sent = client.get_recorded_messages()[-1]
+        received = server.get_recorded_messages()[-1]
+
+        assert (sent.sent, sent.content_type, sent.alert_level) == (
+            True,
+            21,
+            2,
+        )
+        assert received == sent._replace(sent=False)
+
+    def test_message_recorder_disabled(self):
+        """
+        `Connection.get_recorded_messages` returns an empty list unless
+        `Context.set_message_recorder` was called with a positive size
+        before the connection was created.
+        """
+        server, client = self._recorded_connections(0)
+        assert client.get_recorded_messages() == []
+        assert server.get_recorded_messages() == []
+
+        with pytest.raises(ValueError):
+            Context(TLS_METHOD).set_message_recorder(-1)
+
+    def test_message_recorder_stopped(self):
+        """
+        `Context.set_message_recorder` with a size of ``0`` stops OpenSSL
+        calling back into Python for the messages of connections created
+        afterwards if nothing else observes them.
+        """
+        server_context = Context(TLS_METHOD)
+        server_context.use_privatekey(
+            load_privatekey(FILETYPE_PEM, server_key_pem)
+        )
+        server_context.use_certificate(
+            load_certificate(FILETYPE_PEM, server_cert_pem)
+        )
+        client_context = Context(TLS_METHOD)
+        client_context.set_message_recorder(32)
+        client_context.set_message_recorder(0)
+        assert client_context._msg_observers == []
+
+        # Observed only if OpenSSL still calls back into Python.
+        observed = []
+        client_context._msg_observers.append(
+            lambda *args: observed.append(args)
+        )
+        server = Connection(server_context, None)
+        server.set_accept_state()
+        client = Connection(client_context, None)
+        client.set_connect_state()
+        handshake_in_memory(client, server)
+        assert observed == []
+        assert client.get_recorded_messages() == []
+
+    @pytest.mark.parametrize(
+        "version, sigalgs, expected",
+        [
+            (TLS1_3_VERSION, ["rsa_pss_rsae_sha384"], "rsa_pss_rsae_sha384"),
+            (TLS1_2_VERSION, ["RSA+SHA512"], "rsa_pkcs1_sha512"),
+            (
+                TLS1_2_VERSION,
+                ["rsa_pss_rsae_sha512", "RSA+SHA256"],
+                "rsa_pss_rsae_sha512",
+            ),
+        ],
+    )
+    def test_set_sigalgs(self, version, sigalgs, expected):
+        """
+        `Context.set_sigalgs` selects the signature algorithm the server signs
+        the handshake with, which both sides then report.
+        """
+        server_context = Context(TLS_METHOD)
+        server_context.use_privatekey(
+            load_privatekey(FILETYPE_PEM, server_key_pem)
+        )
+        server_context.use_certificate(
+            load_certificate(FILETYPE_PEM, server_cert_pem)
+        )
+        server_context.set_max_proto_version(version)
+        server_context.set_sigalgs(sigalgs)
+        server_context.track_signature_algorithms()
+        client_context = Context(TLS_METHOD)
+        client_context.track_signature_algorithms()
+
+        def server_factory(sock):
+            server = Connection(server_context, sock)
+            server.set_accept_state()
+            return server
+
+        def client_factory(sock):
+            client = Connection(client_context, sock)
+            client.set_connect_state()
+            return client
+
+        server, client = loopback(server_factory, client_factory)
+        assert server.get_protocol_version() == version
+        assert server.get_signature_algorithm() == expected
+        assert client.get_peer_signature_algorithm() == expected
+        assert server.get_peer_signature_algorithm() is None
+        assert client.get_signature_algorithm() is None
+
+    def test_set_sigalgs_invalid(self):
+        """
+        `Context.set_sigalgs` raises `ValueError` for an empty list and
+        `OpenSSL.SSL.Error` for unknown algorithms.
+        """
+        context = Context(TLS_METHOD)
+        with pytest.raises(ValueError):
+            context.set_sigalgs([])
+        with pytest.raises(Error):
+            context.set_sigalgs(["not-an-algorithm"])
+
+    def test_signature_algorithm_untracked(self):
+        """
+        `Connection.get_signature_algorithm` and
+        `Connection.get_peer_signature_algorithm` return `None` unless
+        `Context.track_signature_algorithms` was called.
+        """
+        server, client = loopback()
+        for conn in [server, client]:
+            assert conn.get_signature_algorithm() is None
+            assert conn.get_peer_signature_algorithm() is None
+
     def test_set_session_cache_mode_wrong_args(self):
         """
         `Context.set_session_cache_mode` raises `TypeError` if called with
@@ -2135,6 +2625,293 @@ class TestApplicationLayerProtoNegotiation:
         assert select_args == [(server, [b"http/1.1", b"spdy/2"])]
 
 
+@pytest.mark.skipif(
+    not getattr(_lib, "Cryptography_HAS_PSK", None),
+    reason="PSK not available",
+)
+class TestPSK:
+    """
+    Tests for handshakes with pre-shared keys instead of certificates.
+    """
+
+    key = b"k" * 32
+
+    def _connections(self, server_context, client_context):
+        server = Connection(server_context, None)
+        server.set_accept_state()
+        client = Connection(client_context, None)
+        client.set_connect_state()
+        return server, client
+
+    def _contexts(self, version, identity=b"device", key=key):
+        server_context = Context(TLS_METHOD)
+        client_context = Context(TLS_METHOD)
+        for context in [server_context, client_context]:
+            context.set_min_proto_version(version)
+            context.set_max_proto_version(version)
+            if version == TLS1_2_VERSION:
+                context.set_cipher_list(b"PSK")
+        client_context.set_psk_client_callback(
+            lambda conn, hint: (identity, key)
+        )
+        return server_context, client_context
+
+    @pytest.mark.parametrize("version", [TLS1_2_VERSION, TLS1_3_VERSION])
+    def test_set_psk_keys(self, version):
+        """
+        A server with keys set by `Context.set_psk_keys` and no certificate
+        completes a handshake with a client offering one of them.
+        """
+        server_context, client_context = self._contexts(version)
+        server_context.set_psk_keys({b"device": self.key})
+        server, client = self._connections(server_context, client_context)
+
+        handshake_in_memory(client, server)
+        client.send(b"hello")
+        assert interact_in_memory(client, server) == (server, b"hello")
+        assert server.get_protocol_version() == client.get_protocol_version()
+        assert server.get_peer_certificate() is None
+        assert client.get_peer_certificate() is None
+
+    @pytest.mark.parametrize("hello_retry", [False, True])
+    def test_sha384_cipher_suites(self, hello_retry):
+        """
+        With only cipher suites based on SHA-384 enabled, the client and
+        server associate the PSK with one of them, also when the client has
+        to offer it again after a HelloRetryRequest.
+        """
+        server_context, client_context = self._contexts(TLS1_3_VERSION)
+        for context in [server_context, client_context]:
+            _lib.SSL_CTX_set_ciphersuites(
+                context._context, b"TLS_AES_256_GCM_SHA384"
+            )
+            context.track_hello_retry_requests()
+        if hello_retry:
+            # The client sends an X25519 key share first.
+            server_context.set_tmp_ecdh(get_elliptic_curve("prime256v1"))
+        server_context.set_psk_keys({b"device": self.key})
+        server, client = self._connections(server_context, client_context)
+
+        handshake_in_memory(client, server)
+        assert client.get_cipher_name() == "TLS_AES_256_GCM_SHA384"
+        assert server.get_peer_certificate() is None
+        assert client_context.get_hello_retry_request_count() == hello_retry
+
+    def test_set_psk_keys_wrong_type(self):
+        """
+        `Context.set_psk_keys` raises `TypeError` unless identities and keys
+        are bytes.
+        """
+        context = Context(TLS_METHOD)
+        with pytest.raises(TypeError):
+            context.set_psk_keys({"device": self.key})
+        with pytest.raises(TypeError):
+            context.set_psk_keys({b"device": "key"})
+
+    @pytest.mark.parametrize("version", [TLS1_2_VERSION, TLS1_3_VERSION])
+    def test_unknown_identity(self, version):
+        """
+        The handshake fails if the server has no key for the client's
+        identity.
+        """
+        server_context, client_context = self._contexts(version)
+        server_context.set_psk_keys({b"other": self.key})
+        server, client = self._connections(server_context, client_context)
+
+        with pytest.raises(Error):
+            handshake_in_memory(client, server)
+
+    @pytest.mark.parametrize("version", [TLS1_2_VERSION, TLS1_3_VERSION])
+    def test_wrong_key(self, version):
+        """
+        The handshake fails if the client and server keys differ.
+        """
+        server_context, client_context = self._contexts(version)
+        server_context.set_psk_keys({b"device": b"x" * 32})
+        server, client = self._connections(server_context, client_context)
+
+        with pytest.raises(Error):
+            handshake_in_memory(client, server)
+
+    def test_replace_keys(self):
+        """
+        Keys set by `Context.set_psk_keys` replace the previous keys for
+        subsequent handshakes, including those of existing connections.
+        """
+        server_context, client_context = self._contexts(TLS1_3_VERSION)
+        server_context.set_psk_keys({b"device": self.key})
+        server, client = self._connections(server_context, client_context)
+        server_context.set_psk_keys({b"other": self.key})
+
+        with pytest.raises(Error):
+            handshake_in_memory(client, server)
+
+        server_context.set_psk_keys({b"device": self.key})
+        server, client = self._connections(server_context, client_context)
+        handshake_in_memory(client, server)
+
+    @pytest.mark.parametrize("version", [TLS1_2_VERSION, TLS1_3_VERSION])
+    def test_server_callback(self, version):
+        """
+        The callback set by `Context.set_psk_server_callback` is called with
+        the `Connection` and the identity when the identity is not in the
+        table set by `Context.set_psk_keys`.
+        """
+        server_context, client_context = self._contexts(version)
+        server_context.set_psk_keys({b"other": b"x" * 32})
+        calls = []
+
+        def callback(conn, identity):
+            calls.append((conn, identity))
+            return self.key
+
+        server_context.set_psk_server_callback(callback)
+        server, client = self._connections(server_context, client_context)
+
+        handshake_in_memory(client, server)
+        assert calls == [(server, b"device")]
+
+    def test_server_callback_exception(self):
+        """
+        An exception raised by the callback set by
+        `Context.set_psk_server_callback` propagates out of the handshake.
+        """
+        server_context, client_context = self._contexts(TLS1_3_VERSION)
+
+        def callback(conn, identity):
+            raise ValueError("no key")
+
+        server_context.set_psk_server_callback(callback)
+        server, client = self._connections(server_context, client_context)
+
+        with pytest.raises(ValueError, match="no key"):
+            handshake_in_memory(client, server)
+
+    def test_client_callback_hint(self):
+        """
+        Before TLS 1.3 the callback set by `Context.set_psk_client_callback`
+        is passed the identity hint set by `Context.use_psk_identity_hint`.
+        """
+        server_context, client_context = self._contexts(TLS1_2_VERSION)
+        server_context.use_psk_identity_hint(b"hint")
+        server_context.set_psk_keys({b"device": self.key})
+        hints = []
+
+        def callback(conn, hint):
+            hints.append((conn, hint))
+            return (b"device", self.key)
+
+        client_context.set_psk_client_callback(callback)
+        server, client = self._connections(server_context, client_context)
+
+        handshake_in_memory(client, server)
+        assert hints == [(client, b"hint")]
+
+    def test_client_callback_no_psk(self):
+        """
+        If the callback set by `Context.set_psk_client_callback` returns
+        ``None`` the client offers no PSK and a server without a certificate
+        cannot complete the handshake.
+        """
+        server_context, client_context = self._contexts(TLS1_3_VERSION)
+        server_context.set_psk_keys({b"device": self.key})
+        client_context.set_psk_client_callback(lambda conn, hint: None)
+        server, client = self._connections(server_context, client_context)
+
+        with pytest.raises(Error):
+            handshake_in_memory(client, server)
+
+    def test_client_callback_wrong_type(self):
+        """
+        If the callback set by `Context.set_psk_client_callback` returns an
+        identity that is not bytes, `TypeError` propagates out of the
+        handshake.
+        """
+        server_context, client_context = self._contexts(
+            TLS1_3_VERSION, identity="device"
+        )
+        server_context.set_psk_keys({b"device": self.key})
+        server, client = self._connections(server_context, client_context)
+
+        with pytest.raises(TypeError):
+            handshake_in_memory(client, server)
+
+    def test_use_psk_identity_hint_wrong_type(self):
+        """
+        `Context.use_psk_identity_hint` raises `TypeError` unless the hint is
+        bytes.
+        """
+        with pytest.raises(TypeError):
+            Context(TLS_METHOD).use_psk_identity_hint("hint")
+
+
+@pytest.mark.skipif(
+    not getattr(_lib, "Cryptography_HAS_PROVIDERS", None),
+    reason="Providers not available",
+)
+class TestProvider:
+    """
+    Tests for `load_provider` and `Provider`.
+    """
+
+    def test_load(self):
+        """
+        `load_provider` returns a `Provider` with the given name which can be
+        unloaded, and unloading it twice does nothing.
+        """
+        provider = load_provider(b"default")
+        assert isinstance(provider, Provider)
+        assert provider.name == b"default"
+        provider.unload()
+        provider.unload()
+        # The default provider is still available to new contexts.
+        Connection(Context(TLS_METHOD), None)
+
+    def test_handshake(self):
+        """
+        Connections complete a handshake with the algorithms of a loaded
+        provider.
+        """
+        provider = load_provider(b"default")
+        try:
+            server_context = Context(TLS_METHOD)
+            server_context.use_privatekey(
+                load_privatekey(FILETYPE_PEM, server_key_pem)
+            )
+            server_context.use_certificate(
+                load_certificate(FILETYPE_PEM, server_cert_pem)
+            )
+            server = Connection(server_context, None)
+            server.set_accept_state()
+            client = Connection(Context(TLS_METHOD), None)
+            client.set_connect_state()
+            handshake_in_memory(client, server)
+            assert client.get_protocol_version_name() == "TLSv1.3"
+        finally:
+            provider.unload()
+
+    def test_load_missing(self):
+        """
+        `load_provider` raises `Error` if there is no such provider.
+        """
+        with pytest.raises(Error):
+            load_provider(b"nonexistent")
+
+    def test_load_wrong_type(self):
+        """
+        `load_provider` raises `TypeError` unless the name is bytes.
+        """
+        with pytest.raises(TypeError):
+            load_provider("default")
+
+    def test_instantiate(self):
+        """
+        `Provider` cannot be instantiated directly.
+        """
+        with pytest.raises(TypeError):
+            Provider()
+
+
 class TestSession:
     """
     Unit tests for :py:obj:`OpenSSL.SSL.Session`.
@@ -2529,14 +3306,86 @@ class TestConnection:
         conn.set_app_data(app_data)
         assert conn.get_app_data() is app_data
 
-    def test_makefile(self):
+    def test_makefile_readline(self):
+        """
+        A file object returned by `Connection.makefile` reads lines of data
+        sent by the peer, including lines split across TLS records.
+        """
+        server, client = loopback()
+        server.sendall(b"HELO example\r\nMAIL FROM:<a@")
+        server.sendall(b"example>\r\n" + b"x" * 100000 + b"\r\n")
+        f = client.makefile("rb")
+        assert f.readline() == b"HELO example\r\n"
+        assert f.readline() == b"MAIL FROM:<a@example>\r\n"
+        assert f.readline() == b"x" * 100000 + b"\r\n"
+
+    def test_makefile_text(self):
+        """
+        `Connection.makefile` returns a text stream unless ``"b"`` is in the
+        mode.
+        """
+        server, client = loopback()
+        server.sendall("héllo\nworld\n".encode())
+        f = client.makefile("r", encoding="utf-8")
+        assert f.mode == "r"
+        assert f.readline() == "héllo\n"
+        assert f.readline() == "world\n"
+
+    def test_makefile_write(self):
+        """
+        Data written to a file object returned by `Connection.makefile` is
+        sent when it is flushed.
+        """
+        server, client = loopback()
+        f = client.makefile("wb")
+        f.write(b"hello ")
+        f.write(b"world")
+        f.flush()
+        assert server.recv(1024) == b"hello world"
+
+    def test_makefile_eof(self):
         """
-        `Connection.makefile` is not implemented and calling that
-        method raises `NotImplementedError`.
+        A TLS shutdown by the peer is reported as end of file, and closing the
+        file object leaves the connection usable.
+        """
+        server, client = loopback()
+        f = client.makefile("rwb")
+        f.write(b"ping")
+        f.close()
+        assert server.recv(1024) == b"ping"
+
+        server.sendall(b"bye")
+        server.shutdown()
+        assert client.makefile("rb").read() == b"bye"
+
+    def test_makefile_nonblocking(self):
+        """
+        On a connection which cannot make progress without more data from
+        the transport, the raw file object's ``readinto`` returns `None`.
+        """
+        client = Connection(Context(SSLv23_METHOD), None)
+        server = Connection(loopback_server_factory(None).get_context(), None)
+        handshake_in_memory(client, server)
+
+        raw = client.makefile("rb", buffering=0)
+        assert raw.readinto(bytearray(16)) is None
+        assert client.makefile("rb").read(16) is None
+
+        server.send(b"data")
+        client.bio_write(server.bio_read(4096))
+        assert raw.read(16) == b"data"
+
+    @pytest.mark.parametrize(
+        "mode, buffering", [("rt", None), ("a", None), ("r", 0)]
+    )
+    def test_makefile_invalid(self, mode, buffering):
+        """
+        `Connection.makefile` raises `ValueError` for unsupported modes and
+        for unbuffered text streams.
         """
         conn = Connection(Context(SSLv23_METHOD), None)
-        with pytest.raises(NotImplementedError):
-            conn.makefile()
+        with pytest.raises(ValueError):
+            conn.makefile(mode, buffering)
 
     def test_get_certificate(self):
         """
@@ -3025,6 +3874,135 @@ class TestConnection:
 
         assert server_protocol_version == client_protocol_version
 
+    def test_get_info_before_connect(self):
+        """
+        `Connection.get_info` returns empty values if no connection has been
+        established.
+        """
+        conn = Connection(Context(SSLv23_METHOD), None)
+        info = conn.get_info()
+        assert isinstance(info, ConnectionInfo)
+        assert info.cipher_name is None
+        assert info.cipher_bits is None
+        assert info.alpn_protocol == b""
+        assert info.server_name is None
+        assert info.peer_certificate_digest is None
+
+    def test_get_info(self):
+        """
+        `Connection.get_info` returns the same values as the individual
+        getters.
+        """
+
+        def client_factory(sock):
+            client = loopback_client_factory(sock)
+            client.set_tlsext_host_name(b"example.invalid")
+            client.set_alpn_protos([b"http/1.1"])
+            return client
+
+        def server_factory(sock):
+            server = loopback_server_factory(sock)
+            server.get_context().set_alpn_select_callback(
+                lambda conn, protos: b"http/1.1"
+            )
+            return server
+
+        server, client = loopback(server_factory, client_factory)
+        for conn in [server, client]:
+            info = conn.get_info()
+            assert info.protocol == conn.get_protocol_version_name()
+            assert info.cipher_name == conn.get_cipher_name()
+            assert info.cipher_bits == conn.get_cipher_bits()
+            assert info.alpn_protocol == b"http/1.1"
+            assert info.session_reused in (None, False)
+
+        assert server.get_info().verify_result == X509VerificationCodes.OK
+        # The client does not trust the server's issuer.
+        assert (
+            client.get_info().verify_result
+            == X509VerificationCodes.ERR_UNABLE_TO_GET_ISSUER_CERT_LOCALLY
+        )
+        assert server.get_info().server_name == b"example.invalid"
+        assert server.get_info().peer_certificate_digest is None
+        server_cert = load_certificate(FILETYPE_PEM, server_cert_pem)
+        assert client.get_info(
+            "sha1"
+        ).peer_certificate_digest == server_cert.digest("sha1")
+
+    @pytest.mark.parametrize("version", [TLS1_2_VERSION, TLS1_3_VERSION])
+    def test_session_reused(self, version):
+        """
+        `Connection.session_reused` and `Connection.get_info` tell on both
+        sides whether a handshake resumed a session.
+        """
+        server_context = Context(SSLv23_METHOD)
+        server_context.use_privatekey(
+            load_privatekey(FILETYPE_PEM, server_key_pem)
+        )
+        server_context.use_certificate(
+            load_certificate(FILETYPE_PEM, server_cert_pem)
+        )
+        server_context.set_session_id(b"unity-test")
+        client_context = Context(SSLv23_METHOD)
+        client_context.set_max_proto_version(version)
+        for context in [server_context, client_context]:
+            context.track_session_reuse()
+
+        def connect(session=None):
+            server = Connection(server_context, None)
+            server.set_accept_state()
+            client = Connection(client_context, None)
+            client.set_connect_state()
+            if session is not None:
+                client.set_session(session)
+            handshake_in_memory(client, server)
+            # Deliver the TLS 1.3 session tickets.
+            server.send(b"x")
+            interact_in_memory(client, server)
+            return server, client
+
+        server, client = connect()
+        for conn in [server, client]:
+            assert conn.session_reused() is False
+            assert conn.get_info().session_reused is False
+
+        server, client = connect(client.get_session())
+        for conn in [server, client]:
+            assert conn.get_protocol_version() == version
+            assert conn.session_reused() is True
+            assert conn.get_info().session_reused is True
+
+    def test_session_reused_before_connect(self):
+        """
+        `Connection.session_reused` returns `False` before a handshake.
+        """
+        context = Context(SSLv23_METHOD)
+        context.track_session_reuse()
+        assert Connection(context, None).session_reused() is False
+
+    @pytest.mark.skipif(
+        hasattr(_lib, "SSL_session_reused"),
+        reason="OpenSSL tells whether sessions are reused",
+    )
+    def test_session_reused_untracked(self):
+        """
+        Without ``SSL_session_reused``, `Connection.session_reused` raises
+        `NotImplementedError` and `Connection.get_info` reports `None` unless
+        `Context.track_session_reuse` was called.
+        """
+        conn = Connection(Context(SSLv23_METHOD), None)
+        with pytest.raises(NotImplementedError):
+            conn.session_reused()
+        assert conn.get_info().session_reused is None
+
+    def test_get_info_unknown_digest(self):
+        """
+        `Connection.get_info` raises `ValueError` for an unknown digest.
+        """
+        conn = Connection(Context(SSLv23_METHOD), None)
+        with pytest.raises(ValueError):
+            conn.get_info("monkeys")
+
     def test_wantReadError(self):
         """
         `Connection.bio_read` raises `OpenSSL.SSL.WantReadError` if there are
@@ -3422,6 +4400,149 @@ class TestConnectionRenegotiate:
         while False is server.renegotiate_pending():
             pass
 
+    def _key_update_connections(self):
+        """
+        Return a server and client connected over TLS 1.3 in memory, and a
+        list of the ``(write_p, request_update)`` of every KeyUpdate message
+        the server sends or receives.
+        """
+        key_updates = []
+
+        def observer(write_p, version, content_type, buf, length, ssl):
+            data = _ffi.buffer(buf, length)[:]
+            # KeyUpdate is handshake message type 24.
+            if content_type == 22 and data[:1] == b"\x18":
+                key_updates.append((write_p, data[4]))
+
+        server_context = Context(TLS_METHOD)
+        server_context.use_privatekey(
+            load_privatekey(FILETYPE_PEM, server_key_pem)
+        )
+        server_context.use_certificate(
+            load_certificate(FILETYPE_PEM, server_cert_pem)
+        )
+        server_context.set_min_proto_version(TLS1_3_VERSION)
+        server_context._add_message_observer(observer)
+
+        server = Connection(server_context, None)
+        server.set_accept_state()
+        client = Connection(Context(TLS_METHOD), None)
+        client.set_connect_state()
+        handshake_in_memory(client, server)
+        return server, client, key_updates
+
+    @pytest.mark.skipif(
+        not hasattr(_lib, "SSL_key_update"),
+        reason="Key updates not available",
+    )
+    def test_key_update(self):
+        """
+        `Connection.key_update` sends a KeyUpdate message with the next
+        write, asking the peer to update its keys if *request_peer* is true,
+        and data keeps flowing in both directions.
+        """
+        server, client, key_updates = self._key_update_connections()
+
+        server.key_update()
+        server.send(b"one")
+        assert interact_in_memory(client, server) == (client, b"one")
+        server.key_update(request_peer=True)
+        server.send(b"two")
+        assert interact_in_memory(client, server) == (client, b"two")
+        client.send(b"three")
+        assert interact_in_memory(client, server) == (server, b"three")
+
+        # Sent without and with a request, then the client's response.
+        assert key_updates == [(1, 0), (1, 1), (0, 0)]
+
+    @pytest.mark.skipif(
+        not hasattr(_lib, "SSL_key_update"),
+        reason="Key updates not available",
+    )
+    def test_key_update_limit(self):
+        """
+        After `Connection.set_key_update_limit`, the connection updates its
+        keys once it has sent that many bytes, and asks the peer to once it
+        has received that many bytes.
+        """
+        server, client, key_updates = self._key_update_connections()
+        server.set_key_update_limit(100)
+
+        server.send(b"x" * 60)
+        server.send(b"x" * 60)
+        server.send(b"x")
+        interact_in_memory(client, server)
+        assert key_updates == [(1, 0)]
+
+        client.send(b"x" * 150)
+        interact_in_memory(client, server)
+        server.send(b"x")
+        interact_in_memory(client, server)
+        assert key_updates == [(1, 0), (1, 1)]
+
+        with pytest.raises(ValueError):
+            server.set_key_update_limit(0)
+
+    def test_key_update_limit_counting(self, monkeypatch):
+        """
+        `Connection.set_key_update_limit` makes the connection count the bytes
+        it sends and receives, and `Connection.key_update` restarts the
+        count, whether or not the bindings in use include ``SSL_key_update``.
+        Connections without a limit do not count.
+        """
+        server, client, _ = self._key_update_connections()
+        # Without the binding, the decorated methods only raise
+        # NotImplementedError; test the methods they wrap.
+        set_limit = getattr(
+            Connection.set_key_update_limit,
+            "__wrapped__",
+            Connection.set_key_update_limit,
+        )
+        key_update = getattr(
+            Connection.key_update, "__wrapped__", Connection.key_update
+        )
+        lib = _FakeKeyUpdateLib()
+        monkeypatch.setattr(SSL, "_lib", lib)
+
+        set_limit(server, 100)
+        assert "send" not in vars(server)
+        server.write(b"x" * 60)
+        assert lib.calls == []
+        server.sendall(b"x" * 60)
+        assert lib.calls == [0]
+
+        client.send(b"x" * 150)
+        server.bio_write(client.bio_read(1024))
+        server.recv(100, MSG_PEEK)
+        assert lib.calls == [0]
+        server.recv_into(bytearray(100))
+        assert lib.calls == [0, 1]
+
+        server.send(b"x" * 60)
+        key_update(server, request_peer=True)
+        server.send(b"x" * 60)
+        assert lib.calls == [0, 1, 1]
+
+        set_limit(server, None)
+        server.send(b"x" * 150)
+        assert lib.calls == [0, 1, 1]
+
+    @pytest.mark.skipif(
+        hasattr(_lib, "SSL_key_update"),
+        reason="Key updates available",
+    )
+    def test_key_update_unavailable(self):
+        """
+        `Connection.key_update` and `Connection.set_key_update_limit` raise
+        `NotImplementedError` if the OpenSSL bindings do not support key
+        updates.
+        """
+        connection = Connection(Context(TLS_METHOD), None)
+        with pytest.raises(NotImplementedError):
+            connection.key_update()
+        with pytest.raises(NotImplementedError):
+            connection.set_key_update_limit(2**30)
+
 
 class TestError:
     """